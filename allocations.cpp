@@ -0,0 +1,85 @@
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "graphGenerator.h"
+#include "dijkstra.h"
+#include "heapSelect.h"
+
+using namespace std;
+
+//global allocator calls per heap during dijkstra, in a binary of its own so
+//the counting operator new below never sits under evaluate's timings
+//it only counts calls and times nothing, so it has no reps or BenchWriter
+//  allocations
+
+//every call to the global allocator, so this can show the heaps' hot loops
+//never reach it
+//all three are kept out of line, gcc otherwise sees malloc and free inlined
+//into new and delete expressions and warns that they do not match
+static atomic<long long> allocationCount(0);
+
+[[gnu::noinline]] void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size == 0 ? 1 : size)) return p;
+    throw bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+//global allocator calls during dijkstra, first on a fresh heap and then on
+//a second query through the same heap, result and workspace after reset()
+//the second run is the steady state and should be zero for every heap
+void allocationsSuite() {
+    cout << "heap,graph_type,n,extracts,first_run_allocs,steady_allocs,steady_allocs_per_extract" << endl;
+
+    const int n = 50000;
+    int gridSide = static_cast<int>(sqrt(n));
+    const vector<string>& heaps = heapNames();
+
+    vector<pair<string, Graph>> graphs;
+    graphs.push_back({"sparse", generateRandom(n, true, 3 * n)});
+    graphs.push_back({"grid", generateGrid(gridSide, gridSide, true)});
+    graphs.push_back({"worst", generateWorstCase(n, true)});
+
+    for (const auto& [type, g] : graphs) {
+        for (const string& heap : heaps) {
+            withHeap(heap, [&](auto& pq) {
+                using PQ = typename std::decay<decltype(pq)>::type;
+                DijkstraResult res;
+                DijkstraWorkspace<PQ> ws;
+
+                long long before = allocationCount.load();
+                dijkstra_into(g, 0, pq, res, ws);
+                long long firstRun = allocationCount.load() - before;
+
+                pq.reset();
+                before = allocationCount.load();
+                dijkstra_into(g, 0, pq, res, ws);
+                long long steady = allocationCount.load() - before;
+
+                cout << heap << "," << type << "," << g.num_vertices() << "," << pq.extractCount << ","
+                     << firstRun << "," << steady << ","
+                     << static_cast<double>(steady) / pq.extractCount << endl;
+            });
+        }
+    }
+}
+
+int main() {
+    allocationsSuite();
+    return 0;
+}
@@ -0,0 +1,119 @@
+#ifndef ASTAR_H
+#define ASTAR_H
+
+#include "pointToPoint.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+//smallest edge weight in g, 0 for a graph with no edges
+template<typename GraphT>
+inline int minEdgeWeight(const GraphT& g) {
+    int minW = -1;
+    for (int u = 0; u < g.num_vertices(); ++u) {
+        for (const auto& e : g.neighbors(u)) {
+            if (minW < 0 || e.weight < minW) minW = e.weight;
+        }
+    }
+    return minW < 0 ? 0 : minW;
+}
+
+//h(v) = 0, which turns astar into dijkstra that stops at the target
+struct ZeroHeuristic {
+    long long operator()(int) const { return 0; }
+};
+
+//lower bound for graphs laid out like generateGrid, u = r * cols + c with
+//edges only between horizontal and vertical neighbors
+//every edge moves one step and costs at least minWeight, so the manhattan
+//distance to the target times minWeight never overestimates, and it changes
+//by at most minWeight along an edge, so it is consistent too
+class ManhattanHeuristic {
+public:
+    ManhattanHeuristic(int cols, int target, long long minWeight)
+        : cols_(cols), row_(target / cols), col_(target % cols), minWeight_(minWeight) {
+        if (cols <= 0) throw std::invalid_argument("ManhattanHeuristic: cols must be > 0");
+    }
+
+    //scaled by g's own smallest weight
+    template<typename GraphT>
+    static ManhattanHeuristic forGrid(const GraphT& g, int cols, int target) {
+        return ManhattanHeuristic(cols, target, minEdgeWeight(g));
+    }
+
+    long long operator()(int v) const {
+        int dr = v / cols_ - row_;
+        int dc = v % cols_ - col_;
+        return static_cast<long long>((dr < 0 ? -dr : dr) + (dc < 0 ? -dc : dc)) * minWeight_;
+    }
+
+private:
+    int cols_;
+    int row_;
+    int col_;
+    long long minWeight_;
+};
+
+//goal directed source -> target search, the heap is ordered by dist + h(v)
+//h is any callable int -> long long that never overestimates the distance
+//left to target. with a consistent h (like ManhattanHeuristic) a vertex is
+//settled once; with one that is only admissible a settled vertex can still
+//get a shorter path, it is then reopened and goes back in the heap, so the
+//answer stays exact either way. radix needs monotone keys and so only works
+//with a consistent h
+//stops as soon as target comes out of the heap. pq is reset first
+template<typename GraphT, typename PQ, typename H>
+inline void astar_into(const GraphT& g, int source, int target, PQ& pq, const H& h,
+                       PathResult& res, SearchSpace<PQ>& ws) {
+    static_assert(is_priority_queue<PQ, long long, int>::value,
+                  "astar: PQ must provide the PriorityQueue operations");
+
+    const int n = g.num_vertices();
+    if (source < 0 || source >= n || target < 0 || target >= n) {
+        throw std::out_of_range("astar: vertex out of range");
+    }
+
+    ws.prepare(n);
+    pq.reset();
+
+    res.found = false;
+    res.dist = 0;
+    res.path.clear();
+    res.settled = 0;
+
+    ws.relax(pq, source, 0, h(source), -1);
+
+    while (!pq.is_empty()) {
+        int u = ws.settle(pq);
+        res.settled++;
+        if (u == target) break;
+
+        const long long du = ws.dist[u];
+        for (const auto& e : g.neighbors(u)) {
+            const int v = e.to;
+            const long long nd = du + static_cast<long long>(e.weight);
+            if (nd >= ws.dist[v]) continue;
+            ws.settled[v] = 0;
+            ws.relax(pq, v, nd, nd + h(v), u);
+        }
+    }
+
+    if (!ws.settled[target]) return;
+
+    res.found = true;
+    res.dist = ws.dist[target];
+    for (int v = target; v != -1; v = ws.parent[v]) res.path.push_back(v);
+    std::reverse(res.path.begin(), res.path.end());
+}
+
+//same thing with a fresh workspace and result
+template<typename GraphT, typename PQ, typename H>
+inline PathResult astar(const GraphT& g, int source, int target, PQ& pq, const H& h) {
+    PathResult res;
+    SearchSpace<PQ> ws;
+    astar_into(g, source, target, pq, h, res, ws);
+    return res;
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef BATCH_QUERY_H
+#define BATCH_QUERY_H
+
+#include "dijkstra.h"
+#include "threadPool.h"
+
+#include <memory>
+#include <vector>
+
+//dijkstra from many sources over the same graph
+//sources are handed out to the pool one at a time, each worker keeps one heap
+//and one set of result and handle buffers for the whole batch and resets them
+//between queries, so after the first query nothing is reallocated
+//results stream out through callback(index, source, result) on the worker
+//thread as soon as each query finishes. result is only valid during the call
+//and the callback has to be safe to run from several threads at once
+//PQ is the heap type, e.g. dijkstra_batch<PairingHeap<long long, int>>(...)
+template<typename PQ, typename GraphT, typename Callback>
+inline void dijkstra_batch(const GraphT& g, const std::vector<int>& sources, ThreadPool& pool,
+                           Callback callback, bool lazyInsert = false) {
+    struct Worker {
+        PQ pq;
+        DijkstraResult res;
+        DijkstraWorkspace<PQ> ws;
+    };
+    std::vector<std::unique_ptr<Worker>> workers(pool.size());
+
+    pool.parallel_for(sources.size(), 1, [&](size_t begin, size_t end, int tid) {
+        if (!workers[tid]) workers[tid].reset(new Worker());
+        Worker& w = *workers[tid];
+
+        for (size_t i = begin; i < end; ++i) {
+            w.pq.reset();
+            dijkstra_into(g, sources[i], w.pq, w.res, w.ws, lazyInsert);
+            callback(i, sources[i], static_cast<const DijkstraResult&>(w.res));
+        }
+    });
+}
+
+//same thing with a pool made for this batch
+template<typename PQ, typename GraphT, typename Callback>
+inline void dijkstra_batch(const GraphT& g, const std::vector<int>& sources, int threads,
+                           Callback callback, bool lazyInsert = false) {
+    ThreadPool pool(threads);
+    dijkstra_batch<PQ>(g, sources, pool, callback, lazyInsert);
+}
+
+#endif
@@ -0,0 +1,321 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+//summary of repeated timings, all in milliseconds
+//stddev is the sample standard deviation (n - 1), zero for a single sample
+struct SampleStats {
+    int count = 0;
+    double min = 0;
+    double median = 0;
+    double p95 = 0;
+    double mean = 0;
+    double stddev = 0;
+    double max = 0;
+};
+
+//percentile with linear interpolation between the two closest ranks
+//sorted has to be sorted and non empty, p is in [0, 1]
+inline double percentile(const std::vector<double>& sorted, double p) {
+    const double pos = p * (sorted.size() - 1);
+    const size_t lo = static_cast<size_t>(pos);
+    const size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (pos - lo) * (sorted[hi] - sorted[lo]);
+}
+
+inline SampleStats summarize(std::vector<double> samples) {
+    if (samples.empty()) throw std::invalid_argument("summarize: no samples");
+    std::sort(samples.begin(), samples.end());
+
+    SampleStats s;
+    s.count = static_cast<int>(samples.size());
+    s.min = samples.front();
+    s.max = samples.back();
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+
+    double sum = 0;
+    for (double x : samples) sum += x;
+    s.mean = sum / s.count;
+
+    if (s.count > 1) {
+        double sq = 0;
+        for (double x : samples) sq += (x - s.mean) * (x - s.mean);
+        s.stddev = std::sqrt(sq / (s.count - 1));
+    }
+    return s;
+}
+
+//wall time of one call in milliseconds on the monotonic clock
+template<typename F>
+inline double timeMs(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//command line options for the benchmark harness
+//  --algo dijkstra,prim      --heap pairing,dary4     --gen sparse,grid
+//  --size 1000,5000          --reps 10  --warmup 2    --seed 1
+//  --format csv|json         --perf 0|1 (hardware counter columns)
+//an empty filter list means everything
+struct BenchOptions {
+    std::vector<std::string> algorithms;
+    std::vector<std::string> heaps;
+    std::vector<std::string> generators;
+    std::vector<int> sizes;
+    int reps = 10;
+    int warmup = 2;
+    uint64_t seed = 1;
+    std::string format = "csv";
+    bool perf = false;
+
+    bool wants(const std::vector<std::string>& filter, const std::string& value) const {
+        return filter.empty() || std::find(filter.begin(), filter.end(), value) != filter.end();
+    }
+};
+
+//opts.warmup runs that are thrown away, then opts.reps timed ones
+//run(i) does run i and returns its time in ms, i counts the warmup too so
+//callers can index per run inputs like sources with it
+template<typename Run>
+inline SampleStats repeatRuns(const BenchOptions& opts, Run run) {
+    std::vector<double> samples;
+    for (int i = 0; i < opts.warmup + opts.reps; ++i) {
+        const double ms = run(i);
+        if (i >= opts.warmup) samples.push_back(ms);
+    }
+    return summarize(samples);
+}
+
+//two variants measured in one loop, taking turns at going first, so drift
+//and whatever one leaves in the cache hit both alike
+template<typename RunA, typename RunB>
+inline std::pair<SampleStats, SampleStats> repeatPair(const BenchOptions& opts, RunA runA, RunB runB) {
+    std::vector<double> a, b;
+    for (int i = 0; i < opts.warmup + opts.reps; ++i) {
+        double msA, msB;
+        if (i % 2 == 0) {
+            msA = runA(i);
+            msB = runB(i);
+        } else {
+            msB = runB(i);
+            msA = runA(i);
+        }
+        if (i < opts.warmup) continue;
+        a.push_back(msA);
+        b.push_back(msB);
+    }
+    return {summarize(a), summarize(b)};
+}
+
+//the same for any number of variants, run i starts with variant i % count
+//and goes round from there
+inline std::vector<SampleStats> repeatRotated(const BenchOptions& opts,
+                                              const std::vector<std::function<double(int)>>& runs) {
+    const size_t count = runs.size();
+    std::vector<std::vector<double>> samples(count);
+    for (int i = 0; i < opts.warmup + opts.reps; ++i) {
+        for (size_t k = 0; k < count; ++k) {
+            const size_t v = (i + k) % count;
+            const double ms = runs[v](i);
+            if (i >= opts.warmup) samples[v].push_back(ms);
+        }
+    }
+    std::vector<SampleStats> stats;
+    for (const auto& s : samples) stats.push_back(summarize(s));
+    return stats;
+}
+
+inline std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> parts;
+    std::stringstream in(text);
+    std::string part;
+    while (std::getline(in, part, ',')) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+//parse argv[first..argc) on top of defaults, throws invalid_argument on
+//anything unknown. suites whose runs are long pass fewer default reps
+inline BenchOptions parseBenchOptions(int argc, char* argv[], int first, BenchOptions defaults = BenchOptions()) {
+    BenchOptions opts = defaults;
+
+    for (int i = first; i < argc; ++i) {
+        const std::string flag = argv[i];
+        if (i + 1 >= argc) throw std::invalid_argument("missing value for " + flag);
+        const std::string value = argv[++i];
+
+        //stoi on its own throws with no hint of which option was wrong
+        auto number = [&](const std::string& text) {
+            size_t used = 0;
+            long long x = 0;
+            try {
+                x = std::stoll(text, &used);
+            } catch (const std::logic_error&) {
+                used = 0;
+            }
+            if (used == 0 || used != text.size()) {
+                throw std::invalid_argument("bad value for " + flag + ": " + value);
+            }
+            return x;
+        };
+
+        if (flag == "--algo") {
+            opts.algorithms = splitList(value);
+        } else if (flag == "--heap") {
+            opts.heaps = splitList(value);
+        } else if (flag == "--gen") {
+            opts.generators = splitList(value);
+        } else if (flag == "--size") {
+            opts.sizes.clear();
+            for (const std::string& s : splitList(value)) opts.sizes.push_back(static_cast<int>(number(s)));
+        } else if (flag == "--reps") {
+            opts.reps = static_cast<int>(number(value));
+        } else if (flag == "--warmup") {
+            opts.warmup = static_cast<int>(number(value));
+        } else if (flag == "--seed") {
+            opts.seed = static_cast<uint64_t>(number(value));
+        } else if (flag == "--format") {
+            opts.format = value;
+        } else if (flag == "--perf") {
+            opts.perf = number(value) != 0;
+        } else {
+            throw std::invalid_argument("unknown option " + flag);
+        }
+    }
+
+    if (opts.reps < 1) throw std::invalid_argument("--reps must be >= 1");
+    if (opts.warmup < 0) throw std::invalid_argument("--warmup must be >= 0");
+    if (opts.format != "csv" && opts.format != "json") {
+        throw std::invalid_argument("--format must be csv or json");
+    }
+    return opts;
+}
+
+//one output row, fields keep the order they were added in
+class BenchRecord {
+public:
+    struct Field {
+        std::string key;
+        std::string text;
+        bool quoted;  //strings are quoted in json, numbers are not
+        bool missing; //NA in csv, null in json
+    };
+
+    BenchRecord& add(const std::string& key, const std::string& value) {
+        fields_.push_back({key, value, true, false});
+        return *this;
+    }
+
+    BenchRecord& add(const std::string& key, const char* value) {
+        return add(key, std::string(value));
+    }
+
+    BenchRecord& add(const std::string& key, long long value) {
+        fields_.push_back({key, std::to_string(value), false, false});
+        return *this;
+    }
+
+    BenchRecord& add(const std::string& key, int value) {
+        return add(key, static_cast<long long>(value));
+    }
+
+    //inf and nan (a ratio over a 0 ms timing) are not valid json numbers,
+    //they count as not measured
+    BenchRecord& add(const std::string& key, double value) {
+        if (!std::isfinite(value)) return addMissing(key);
+        std::ostringstream out;
+        out << std::setprecision(6) << value;
+        fields_.push_back({key, out.str(), false, false});
+        return *this;
+    }
+
+    //a value that could not be measured
+    BenchRecord& addMissing(const std::string& key) {
+        fields_.push_back({key, "NA", false, true});
+        return *this;
+    }
+
+    const std::vector<Field>& fields() const { return fields_; }
+
+private:
+    std::vector<Field> fields_;
+};
+
+//the summary columns of st with every key prefixed, e.g. csr_median_ms
+inline void addTiming(BenchRecord& rec, const std::string& prefix, const SampleStats& st) {
+    rec.add(prefix + "median_ms", st.median).add(prefix + "p95_ms", st.p95).add(prefix + "mean_ms", st.mean)
+       .add(prefix + "stddev_ms", st.stddev).add(prefix + "min_ms", st.min).add(prefix + "max_ms", st.max);
+}
+
+//streams records as csv (header taken from the first record) or as a json
+//array of objects. finish() closes the json array
+class BenchWriter {
+public:
+    BenchWriter(std::ostream& out, const std::string& format)
+        : out_(out), json_(format == "json"), rows_(0) {}
+
+    void write(const BenchRecord& rec) {
+        const auto& fields = rec.fields();
+        if (json_) {
+            out_ << (rows_ == 0 ? "[\n  {" : ",\n  {");
+            for (size_t i = 0; i < fields.size(); ++i) {
+                if (i > 0) out_ << ", ";
+                out_ << '"' << fields[i].key << "\": ";
+                if (fields[i].missing) {
+                    out_ << "null";
+                } else if (fields[i].quoted) {
+                    out_ << '"' << escape(fields[i].text) << '"';
+                } else {
+                    out_ << fields[i].text;
+                }
+            }
+            out_ << "}";
+        } else {
+            if (rows_ == 0) {
+                for (size_t i = 0; i < fields.size(); ++i) out_ << (i > 0 ? "," : "") << fields[i].key;
+                out_ << "\n";
+            }
+            for (size_t i = 0; i < fields.size(); ++i) out_ << (i > 0 ? "," : "") << fields[i].text;
+            out_ << "\n";
+        }
+        rows_++;
+        out_.flush();
+    }
+
+    void finish() {
+        if (json_) out_ << (rows_ == 0 ? "[]\n" : "\n]\n");
+        out_.flush();
+    }
+
+private:
+    std::ostream& out_;
+    bool json_;
+    long long rows_;
+
+    static std::string escape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+};
+
+#endif
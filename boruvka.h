@@ -0,0 +1,202 @@
+#ifndef BORUVKA_H
+#define BORUVKA_H
+
+#include "prim.h"
+#include "threadPool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//lock free union find
+//find does path halving with CAS, unite links the higher numbered root
+//under the lower one, and both can run from many threads at once
+class ConcurrentUnionFind {
+public:
+    explicit ConcurrentUnionFind(int n) : parent_(n) {
+        for (int i = 0; i < n; ++i) parent_[i].store(i, std::memory_order_relaxed);
+    }
+
+    int find(int x) {
+        while (true) {
+            int p = parent_[x].load(std::memory_order_relaxed);
+            if (p == x) return x;
+            int gp = parent_[p].load(std::memory_order_relaxed);
+            if (p != gp) parent_[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            x = gp;
+        }
+    }
+
+    //true if a and b were in different sets
+    bool unite(int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+            if (a > b) std::swap(a, b);
+            int expected = b;
+            if (parent_[b].compare_exchange_strong(expected, a, std::memory_order_relaxed)) return true;
+        }
+    }
+
+private:
+    std::vector<std::atomic<int>> parent_;
+};
+
+//parallel minimum spanning forest with boruvka's algorithm
+//every round each component picks its lightest edge to another component
+//(an atomic min over weight and target packed into 64 bits), then all picks
+//are united in parallel. a pick that would close a cycle, which only happens
+//between equal weight edges, is rejected by the union find
+//returns the whole forest in PrimResult form, each tree rooted at its lowest
+//vertex except start's which is rooted at start. total_weight covers every
+//tree, so it equals prim_mst whenever the graph is connected
+template<typename GraphT>
+inline PrimResult boruvka_mst(const GraphT& g, int start, ThreadPool& pool) {
+    const int n = g.num_vertices();
+    if (start < 0 || start >= n) throw std::out_of_range("boruvka_mst: start out of range");
+    if (g.directed()) throw std::invalid_argument("boruvka_mst: Boruvka requires an undirected graph");
+
+    const long long INF = std::numeric_limits<long long>::max() / 4;
+    const uint64_t NONE = std::numeric_limits<uint64_t>::max();
+    const size_t GRAIN = 256;
+
+    ConcurrentUnionFind uf(n);
+    std::vector<std::atomic<uint64_t>> best(n);
+    std::vector<std::atomic<int>> bestFrom(n);
+
+    std::vector<int> roots(n);
+    for (int v = 0; v < n; ++v) roots[v] = v;
+
+    struct TreeEdge {
+        int u;
+        int v;
+        int weight;
+    };
+    std::vector<std::vector<TreeEdge>> picked(pool.size());
+
+    while (true) {
+        for (int r : roots) {
+            best[r].store(NONE, std::memory_order_relaxed);
+            bestFrom[r].store(n, std::memory_order_relaxed);
+        }
+
+        //lightest edge leaving each component, packed as weight << 32 | target
+        pool.parallel_for(n, GRAIN, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; ++i) {
+                const int u = static_cast<int>(i);
+                const int cu = uf.find(u);
+                uint64_t mine = NONE;
+                for (const auto& e : g.neighbors(u)) {
+                    uint64_t key = (static_cast<uint64_t>(e.weight) << 32) | static_cast<uint32_t>(e.to);
+                    if (key < mine && uf.find(e.to) != cu) mine = key;
+                }
+                uint64_t cur = best[cu].load(std::memory_order_relaxed);
+                while (mine < cur && !best[cu].compare_exchange_weak(cur, mine, std::memory_order_relaxed)) {
+                }
+            }
+        });
+
+        //the pick only names the target, find the lowest vertex in the
+        //component that has that edge to use as its source
+        pool.parallel_for(n, GRAIN, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; ++i) {
+                const int u = static_cast<int>(i);
+                const int cu = uf.find(u);
+                const uint64_t key = best[cu].load(std::memory_order_relaxed);
+                if (key == NONE) continue;
+                const int v = static_cast<int>(key & 0xffffffffu);
+                const int w = static_cast<int>(key >> 32);
+                for (const auto& e : g.neighbors(u)) {
+                    if (e.to == v && e.weight == w) {
+                        int cur = bestFrom[cu].load(std::memory_order_relaxed);
+                        while (u < cur && !bestFrom[cu].compare_exchange_weak(cur, u, std::memory_order_relaxed)) {
+                        }
+                        break;
+                    }
+                }
+            }
+        });
+
+        //join along every pick at once
+        std::atomic<bool> merged(false);
+        pool.parallel_for(roots.size(), GRAIN, [&](size_t begin, size_t end, int tid) {
+            for (size_t i = begin; i < end; ++i) {
+                const int r = roots[i];
+                const uint64_t key = best[r].load(std::memory_order_relaxed);
+                if (key == NONE) continue;
+                const int u = bestFrom[r].load(std::memory_order_relaxed);
+                const int v = static_cast<int>(key & 0xffffffffu);
+                if (uf.unite(u, v)) {
+                    picked[tid].push_back({u, v, static_cast<int>(key >> 32)});
+                    merged.store(true, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        if (!merged.load()) break;
+
+        size_t kept = 0;
+        for (int r : roots) {
+            if (uf.find(r) == r) roots[kept++] = r;
+        }
+        roots.resize(kept);
+    }
+
+    PrimResult res;
+    res.parent.assign(n, -1);
+    res.key.assign(n, INF);
+    res.connected = (roots.size() == 1);
+
+    //orient the forest with a bfs from start, then from the lowest vertex of
+    //every other tree
+    std::vector<std::vector<std::pair<int, int>>> tree(n);
+    long long total = 0;
+    for (const auto& list : picked) {
+        for (const auto& e : list) {
+            tree[e.u].push_back({e.v, e.weight});
+            tree[e.v].push_back({e.u, e.weight});
+            total += e.weight;
+        }
+    }
+    res.total_weight = total;
+
+    std::vector<bool> seen(n, false);
+    std::vector<int> queue;
+    queue.reserve(n);
+    auto orient = [&](int root) {
+        seen[root] = true;
+        res.key[root] = 0;
+        queue.clear();
+        queue.push_back(root);
+        for (size_t i = 0; i < queue.size(); ++i) {
+            const int u = queue[i];
+            for (const auto& [v, w] : tree[u]) {
+                if (seen[v]) continue;
+                seen[v] = true;
+                res.parent[v] = u;
+                res.key[v] = w;
+                queue.push_back(v);
+            }
+        }
+    };
+
+    orient(start);
+    for (int v = 0; v < n; ++v) {
+        if (!seen[v]) orient(v);
+    }
+
+    return res;
+}
+
+//same thing with a pool made for this one call
+template<typename GraphT>
+inline PrimResult boruvka_mst(const GraphT& g, int start, int threads) {
+    ThreadPool pool(threads);
+    return boruvka_mst(g, start, pool);
+}
+
+#endif
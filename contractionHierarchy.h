@@ -0,0 +1,573 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "pointToPoint.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+//one arc of the hierarchy, middle is the vertex a shortcut skips over and -1
+//for an edge of the original graph
+struct CHArc {
+    int to;
+    int middle;
+    long long weight;
+};
+
+static_assert(sizeof(CHArc) == 16, "CHArc layout is part of the file format");
+
+//read only view over one vertex's arcs
+struct CHArcRange {
+    const CHArc* first;
+    const CHArc* last;
+
+    const CHArc* begin() const { return first; }
+    const CHArc* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+};
+
+struct CHOptions {
+    //a witness search gives up after settling this many vertices and the
+    //shortcut is added anyway, which costs space but never correctness
+    int witnessSettleLimit = 500;
+};
+
+//binary hierarchy file, version 1
+//  header       CHFileHeader, 64 bytes
+//  rank         n int32
+//  up offsets   (n + 1) int64, then up arcs CHArc
+//  down offsets (n + 1) int64, then down arcs CHArc
+//machine byte order, read back with ContractionHierarchy::load
+const char CH_FILE_MAGIC[8] = {'C', 'S', '4', '7', '0', 'C', 'H', 'F'};
+const uint32_t CH_FILE_VERSION = 1;
+
+struct CHFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    int64_t n;
+    int64_t upArcs;
+    int64_t downArcs;
+    int64_t shortcuts;
+    int64_t reserved[2];
+};
+
+static_assert(sizeof(CHFileHeader) == 64, "CHFileHeader must stay 64 bytes");
+
+template<typename PQ>
+class CHBuilder;
+
+//contraction hierarchy over a fixed graph
+//build() contracts the vertices one at a time in order of importance and
+//adds a shortcut u -> x for every u -> v -> x that was a shortest path and
+//would be lost with v. the rank of a vertex is when it was contracted
+//every arc, original or shortcut, ends up stored once: at its lower ranked
+//end, in up() if it leaves that end and in down() if it enters it, so a
+//query only ever walks towards higher ranks from both sides
+class ContractionHierarchy {
+public:
+    ContractionHierarchy() : n_(0), shortcuts_(0), upOffsets_(1, 0), downOffsets_(1, 0) {}
+
+    //preprocess g, PQ is the heap for the witness searches and the order
+    //queue. the order queue's keys go down as well as up, so not radix
+    template<typename PQ, typename GraphT>
+    static ContractionHierarchy build(const GraphT& g, const CHOptions& opts = CHOptions()) {
+        CHBuilder<PQ> builder(g, opts);
+        return builder.run();
+    }
+
+    int num_vertices() const { return n_; }
+    long long num_shortcuts() const { return shortcuts_; }
+    long long num_arcs() const { return static_cast<long long>(upArcs_.size() + downArcs_.size()); }
+    int rank(int v) const { return rank_[v]; }
+
+    //arcs u -> x with rank(x) > rank(u)
+    CHArcRange up(int u) const {
+        return {upArcs_.data() + upOffsets_[u], upArcs_.data() + upOffsets_[u + 1]};
+    }
+
+    //arcs x -> u with rank(x) > rank(u), stored as u's with to = x
+    CHArcRange down(int u) const {
+        return {downArcs_.data() + downOffsets_[u], downArcs_.data() + downOffsets_[u + 1]};
+    }
+
+    //shortest source -> target distance, forward on up() from the source and
+    //backward on down() from the target, both only climbing. a side stops
+    //once its heap minimum is no better than the best meeting found, the
+    //query ends when both have. with unpack the shortcuts on the path are
+    //expanded back into original edges. both heaps are reset first
+    template<typename PQ>
+    void query_into(int source, int target, PQ& fwd, PQ& bwd, PathResult& res,
+                    BidirectionalWorkspace<PQ>& ws, bool unpack = true) const {
+        static_assert(is_priority_queue<PQ, long long, int>::value,
+                      "ContractionHierarchy: PQ must provide the PriorityQueue operations");
+        if (source < 0 || source >= n_ || target < 0 || target >= n_) {
+            throw std::out_of_range("ContractionHierarchy::query: vertex out of range");
+        }
+
+        SearchSpace<PQ>& f = ws.forward;
+        SearchSpace<PQ>& b = ws.backward;
+        f.prepare(n_);
+        b.prepare(n_);
+        fwd.reset();
+        bwd.reset();
+
+        res.found = false;
+        res.dist = 0;
+        res.path.clear();
+        res.settled = 0;
+
+        f.relax(fwd, source, 0, -1);
+        b.relax(bwd, target, 0, -1);
+
+        long long mu = SearchSpace<PQ>::INF;
+        int meet = -1;
+
+        while (true) {
+            const bool goF = !fwd.is_empty() && fwd.find_min().first < mu;
+            const bool goB = !bwd.is_empty() && bwd.find_min().first < mu;
+            if (!goF && !goB) break;
+            const bool forward = goF && (!goB || fwd.find_min().first <= bwd.find_min().first);
+
+            SearchSpace<PQ>& sp = forward ? f : b;
+            SearchSpace<PQ>& other = forward ? b : f;
+            PQ& pq = forward ? fwd : bwd;
+
+            int u = sp.settle(pq);
+            res.settled++;
+            const long long du = sp.dist[u];
+            if (other.reached(u) && du + other.dist[u] < mu) {
+                mu = du + other.dist[u];
+                meet = u;
+            }
+            for (const CHArc& a : forward ? up(u) : down(u)) {
+                sp.relax(pq, a.to, du + a.weight, u);
+            }
+        }
+
+        if (meet < 0) return;
+
+        res.found = true;
+        res.dist = mu;
+        if (!unpack) return;
+
+        //meet back to the source unpacked in reverse and turned around, then
+        //meet on to the target
+        std::vector<std::pair<int, int>> stack;
+        for (int v = meet; f.parent[v] != -1; v = f.parent[v]) unpackArc(f.parent[v], v, res.path, stack, true);
+        res.path.push_back(source);
+        std::reverse(res.path.begin(), res.path.end());
+        for (int v = meet; b.parent[v] != -1; v = b.parent[v]) unpackArc(v, b.parent[v], res.path, stack, false);
+    }
+
+    //same thing with a fresh workspace and result
+    template<typename PQ>
+    PathResult query(int source, int target, PQ& fwd, PQ& bwd, bool unpack = true) const {
+        PathResult res;
+        BidirectionalWorkspace<PQ> ws;
+        query_into(source, target, fwd, bwd, res, ws, unpack);
+        return res;
+    }
+
+    void save(const std::string& path) const {
+        CHFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, CH_FILE_MAGIC, sizeof(header.magic));
+        header.version = CH_FILE_VERSION;
+        header.n = n_;
+        header.upArcs = static_cast<int64_t>(upArcs_.size());
+        header.downArcs = static_cast<int64_t>(downArcs_.size());
+        header.shortcuts = shortcuts_;
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("ContractionHierarchy::save: cannot open " + path);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeArray(out, rank_);
+        writeArray(out, upOffsets_);
+        writeArray(out, upArcs_);
+        writeArray(out, downOffsets_);
+        writeArray(out, downArcs_);
+        if (!out) throw std::runtime_error("ContractionHierarchy::save: write failed for " + path);
+    }
+
+    static ContractionHierarchy load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("ContractionHierarchy::load: cannot open " + path);
+
+        CHFileHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            throw std::runtime_error("ContractionHierarchy::load: file too small for a header: " + path);
+        }
+        if (std::memcmp(header.magic, CH_FILE_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("ContractionHierarchy::load: not a hierarchy file: " + path);
+        }
+        if (header.version != CH_FILE_VERSION) {
+            throw std::runtime_error("ContractionHierarchy::load: unsupported version in " + path);
+        }
+        if (header.n < 0 || header.n > INT_MAX || header.upArcs < 0 || header.downArcs < 0 || header.shortcuts < 0) {
+            throw std::runtime_error("ContractionHierarchy::load: corrupt header in " + path);
+        }
+
+        //the counts are checked against what is left of the file before
+        //anything is allocated for them
+        const std::streamoff here = in.tellg();
+        in.seekg(0, std::ios::end);
+        int64_t remaining = static_cast<int64_t>(in.tellg() - here);
+        in.seekg(here);
+
+        ContractionHierarchy ch;
+        ch.n_ = static_cast<int>(header.n);
+        ch.shortcuts_ = header.shortcuts;
+        readArray(in, ch.rank_, ch.n_, remaining, path);
+        readArray(in, ch.upOffsets_, header.n + 1, remaining, path);
+        readArray(in, ch.upArcs_, header.upArcs, remaining, path);
+        readArray(in, ch.downOffsets_, header.n + 1, remaining, path);
+        readArray(in, ch.downArcs_, header.downArcs, remaining, path);
+        ch.validate(path);
+        return ch;
+    }
+
+private:
+    template<typename PQ>
+    friend class CHBuilder;
+
+    int n_;
+    long long shortcuts_;
+    std::vector<int> rank_;
+    std::vector<long long> upOffsets_;
+    std::vector<CHArc> upArcs_;
+    std::vector<long long> downOffsets_;
+    std::vector<CHArc> downArcs_;
+
+    //the stored arc a -> b, from whichever end has the lower rank, or null
+    const CHArc* findArc(int a, int b) const {
+        if (rank_[a] < rank_[b]) {
+            for (const CHArc& x : up(a)) {
+                if (x.to == b) return &x;
+            }
+        } else {
+            for (const CHArc& x : down(b)) {
+                if (x.to == a) return &x;
+            }
+        }
+        return nullptr;
+    }
+
+    const CHArc& arc(int a, int b) const {
+        const CHArc* x = findArc(a, b);
+        if (x == nullptr) throw std::logic_error("ContractionHierarchy: path uses an arc that is not stored");
+        return *x;
+    }
+
+    //appends the original vertices after a on the arc a -> b, ending with b,
+    //or with reversed the same ones from b back to the one after a
+    //a shortcut a -> b through m is a -> m then m -> b, expanded with an
+    //explicit stack since shortcuts nest as deep as the hierarchy is tall
+    void unpackArc(int a, int b, std::vector<int>& path, std::vector<std::pair<int, int>>& stack,
+                   bool reversed) const {
+        stack.clear();
+        stack.push_back({a, b});
+        while (!stack.empty()) {
+            auto [x, y] = stack.back();
+            stack.pop_back();
+            const int m = arc(x, y).middle;
+            if (m < 0) {
+                path.push_back(y);
+            } else if (reversed) {
+                stack.push_back({x, m});
+                stack.push_back({m, y});
+            } else {
+                stack.push_back({m, y});
+                stack.push_back({x, m});
+            }
+        }
+    }
+
+    //everything a query and unpackArc rely on, so a corrupt file fails here
+    //and not later with a bad index, a missing arc or an unpacking loop:
+    //rank is a permutation, every arc leads up in rank, and a shortcut's
+    //middle ranks below both ends and both its halves are stored. unpacking
+    //then always steps down in rank and has to stop
+    void validate(const std::string& path) const {
+        std::vector<char> seen(n_, 0);
+        for (int r : rank_) {
+            if (r < 0 || r >= n_ || seen[r]) throw std::runtime_error("ContractionHierarchy::load: bad rank in " + path);
+            seen[r] = 1;
+        }
+
+        auto check = [&](const std::vector<long long>& offsets, const std::vector<CHArc>& arcs) {
+            if (offsets[0] != 0 || offsets[n_] != static_cast<long long>(arcs.size())) return false;
+            for (int u = 0; u < n_; ++u) {
+                if (offsets[u] > offsets[u + 1]) return false;
+            }
+            for (int u = 0; u < n_; ++u) {
+                for (long long i = offsets[u]; i < offsets[u + 1]; ++i) {
+                    const CHArc& a = arcs[i];
+                    if (a.to < 0 || a.to >= n_ || a.middle < -1 || a.middle >= n_ || a.weight < 0) return false;
+                    if (rank_[a.to] <= rank_[u]) return false;
+                    if (a.middle >= 0 && rank_[a.middle] >= rank_[u]) return false;
+                }
+            }
+            return true;
+        };
+        if (!check(upOffsets_, upArcs_) || !check(downOffsets_, downArcs_)) {
+            throw std::runtime_error("ContractionHierarchy::load: corrupt arc arrays in " + path);
+        }
+
+        //up(u) holds u -> to, down(u) holds to -> u
+        for (int u = 0; u < n_; ++u) {
+            for (const CHArc& a : up(u)) {
+                if (a.middle >= 0 && (findArc(u, a.middle) == nullptr || findArc(a.middle, a.to) == nullptr)) {
+                    throw std::runtime_error("ContractionHierarchy::load: shortcut without its halves in " + path);
+                }
+            }
+            for (const CHArc& a : down(u)) {
+                if (a.middle >= 0 && (findArc(a.to, a.middle) == nullptr || findArc(a.middle, u) == nullptr)) {
+                    throw std::runtime_error("ContractionHierarchy::load: shortcut without its halves in " + path);
+                }
+            }
+        }
+    }
+
+    template<typename T>
+    static void writeArray(std::ofstream& out, const std::vector<T>& v) {
+        out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+    }
+
+    template<typename T>
+    //remaining is the bytes left in the file, so a bad count is caught before
+    //resize and count * sizeof(T) cannot overflow
+    static void readArray(std::ifstream& in, std::vector<T>& v, int64_t count, int64_t& remaining,
+                          const std::string& path) {
+        if (count < 0 || count > remaining / static_cast<int64_t>(sizeof(T))) {
+            throw std::runtime_error("ContractionHierarchy::load: file is truncated: " + path);
+        }
+        v.resize(static_cast<size_t>(count));
+        if (!in.read(reinterpret_cast<char*>(v.data()), static_cast<std::streamsize>(count * sizeof(T)))) {
+            throw std::runtime_error("ContractionHierarchy::load: file is truncated: " + path);
+        }
+        remaining -= count * static_cast<int64_t>(sizeof(T));
+    }
+};
+
+//the preprocessing, kept apart so its working graph is gone once it is done
+//vertices come out of a min heap on priority
+//  shortcuts contracting would add - arcs it would remove + neighbors
+//  already contracted
+//priorities only get recomputed for the neighbors of a contracted vertex
+//and for the vertex at the top of the queue. a lower one is a decrease_key,
+//a higher one waits until the vertex comes out and is then put back in
+template<typename PQ>
+class CHBuilder {
+public:
+    template<typename GraphT>
+    CHBuilder(const GraphT& g, const CHOptions& opts)
+        : n_(g.num_vertices()), opts_(opts), out_(n_), in_(n_), deleted_(n_, 0),
+          upArcs_(n_), downArcs_(n_), target_(n_, 0) {
+        for (int u = 0; u < n_; ++u) {
+            for (const auto& e : g.neighbors(u)) {
+                if (e.to != u) addArc(u, e.to, e.weight, -1);
+            }
+        }
+    }
+
+    ContractionHierarchy run() {
+        ContractionHierarchy ch;
+        ch.n_ = n_;
+        ch.rank_.assign(n_, 0);
+
+        using Handle = pq_handle_t<PQ, long long, int>;
+        PQ order;
+        std::vector<Handle> handle(n_, nullptr);
+        std::vector<long long> key(n_);
+        for (int v = 0; v < n_; ++v) {
+            key[v] = priority(v);
+            handle[v] = order.insert(key[v], v);
+        }
+
+        std::vector<int> neighbors;
+        int next = 0;
+        while (!order.is_empty()) {
+            int v = order.extract_min().second;
+            handle[v] = nullptr;
+            key[v] = priority(v);
+            if (!order.is_empty() && key[v] > order.find_min().first) {
+                handle[v] = order.insert(key[v], v);
+                continue;
+            }
+
+            neighbors.clear();
+            for (const Arc& a : out_[v]) neighbors.push_back(a.to);
+            for (const Arc& a : in_[v]) neighbors.push_back(a.to);
+            contract(v);
+            ch.rank_[v] = next++;
+
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            for (int w : neighbors) {
+                deleted_[w]++;
+                long long p = priority(w);
+                if (p < key[w]) {
+                    order.decrease_key(handle[w], p);
+                    key[w] = p;
+                }
+            }
+        }
+
+        flatten(upArcs_, ch.upOffsets_, ch.upArcs_);
+        flatten(downArcs_, ch.downOffsets_, ch.downArcs_);
+        ch.shortcuts_ = 0;
+        for (const CHArc& a : ch.upArcs_) ch.shortcuts_ += a.middle >= 0;
+        for (const CHArc& a : ch.downArcs_) ch.shortcuts_ += a.middle >= 0;
+        return ch;
+    }
+
+private:
+    //working graph arc, to is the other end for both out_ and in_
+    struct Arc {
+        int to;
+        int middle;
+        long long weight;
+    };
+
+    struct Shortcut {
+        int from;
+        int to;
+        long long weight;
+    };
+
+    int n_;
+    CHOptions opts_;
+    std::vector<std::vector<Arc>> out_;
+    std::vector<std::vector<Arc>> in_;
+    std::vector<int> deleted_;
+    std::vector<std::vector<CHArc>> upArcs_;
+    std::vector<std::vector<CHArc>> downArcs_;
+
+    SearchSpace<PQ> witness_;
+    PQ witnessPq_;
+    std::vector<int> target_;  //== stamp_ for the current witness search's targets
+    int stamp_ = 0;
+    std::vector<Shortcut> found_;
+
+    static Arc* find(std::vector<Arc>& arcs, int to) {
+        for (Arc& a : arcs) {
+            if (a.to == to) return &a;
+        }
+        return nullptr;
+    }
+
+    //adds u -> x or lowers the one already there, parallel arcs are merged
+    void addArc(int u, int x, long long weight, int middle) {
+        Arc* a = find(out_[u], x);
+        if (a == nullptr) {
+            out_[u].push_back({x, middle, weight});
+            in_[x].push_back({u, middle, weight});
+            return;
+        }
+        if (weight >= a->weight) return;
+        a->weight = weight;
+        a->middle = middle;
+        Arc* b = find(in_[x], u);
+        b->weight = weight;
+        b->middle = middle;
+    }
+
+    static void remove(std::vector<Arc>& arcs, int to) {
+        for (size_t i = 0; i < arcs.size(); ++i) {
+            if (arcs[i].to == to) {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+                return;
+            }
+        }
+    }
+
+    //local dijkstra from u that never goes through v, until every vertex
+    //marked as a target is settled, the next key passes limit or the settle
+    //limit runs out
+    void witnessSearch(int u, int v, long long limit, int targets) {
+        witness_.prepare(n_);
+        witnessPq_.reset();
+        witness_.relax(witnessPq_, u, 0, -1);
+        int settled = 0;
+        while (targets > 0 && !witnessPq_.is_empty() && witnessPq_.find_min().first <= limit) {
+            if (++settled > opts_.witnessSettleLimit) break;
+            int x = witness_.settle(witnessPq_);
+            if (target_[x] == stamp_) targets--;
+            const long long dx = witness_.dist[x];
+            for (const Arc& a : out_[x]) {
+                //past limit it cannot be a witness, keep it out of the heap
+                if (a.to != v && dx + a.weight <= limit) witness_.relax(witnessPq_, a.to, dx + a.weight, x);
+            }
+        }
+    }
+
+    //fills found_ with the shortcuts contracting v needs
+    void findShortcuts(int v) {
+        found_.clear();
+        for (const Arc& in : in_[v]) {
+            const int u = in.to;
+            long long maxOut = -1;
+            int targets = 0;
+            stamp_++;
+            for (const Arc& out : out_[v]) {
+                if (out.to == u) continue;
+                if (out.weight > maxOut) maxOut = out.weight;
+                target_[out.to] = stamp_;
+                targets++;
+            }
+            if (targets == 0) continue;
+
+            witnessSearch(u, v, in.weight + maxOut, targets);
+            for (const Arc& out : out_[v]) {
+                if (out.to == u) continue;
+                const long long through = in.weight + out.weight;
+                if (witness_.dist[out.to] > through) found_.push_back({u, out.to, through});
+            }
+        }
+    }
+
+    long long priority(int v) {
+        findShortcuts(v);
+        return static_cast<long long>(found_.size()) - static_cast<long long>(in_[v].size() + out_[v].size()) +
+               deleted_[v];
+    }
+
+    void contract(int v) {
+        findShortcuts(v);
+        for (const Shortcut& s : found_) addArc(s.from, s.to, s.weight, v);
+
+        //whatever v still connects to is contracted later, so ranks higher
+        for (const Arc& a : out_[v]) {
+            upArcs_[v].push_back({a.to, a.middle, a.weight});
+            remove(in_[a.to], v);
+        }
+        for (const Arc& a : in_[v]) {
+            downArcs_[v].push_back({a.to, a.middle, a.weight});
+            remove(out_[a.to], v);
+        }
+        std::vector<Arc>().swap(out_[v]);
+        std::vector<Arc>().swap(in_[v]);
+    }
+
+    void flatten(std::vector<std::vector<CHArc>>& lists, std::vector<long long>& offsets, std::vector<CHArc>& arcs) {
+        offsets.assign(n_ + 1, 0);
+        for (int u = 0; u < n_; ++u) offsets[u + 1] = offsets[u] + static_cast<long long>(lists[u].size());
+        arcs.clear();
+        arcs.reserve(static_cast<size_t>(offsets[n_]));
+        for (int u = 0; u < n_; ++u) {
+            arcs.insert(arcs.end(), lists[u].begin(), lists[u].end());
+            std::vector<CHArc>().swap(lists[u]);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "graph.h"
+
+#include <vector>
+#include <stdexcept>
+#include <utility>
+
+//read only view over a contiguous run of edges
+//csr graphs hand this out instead of a vector per vertex
+struct EdgeRange {
+    const Graph::Edge* first;
+    const Graph::Edge* last;
+
+    const Graph::Edge* begin() const { return first; }
+    const Graph::Edge* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    const Graph::Edge& operator[](size_t i) const { return first[i]; }
+};
+
+//frozen compressed sparse row graph
+//edges of u live in edges_[offsets_[u] .. offsets_[u+1])
+//same interface as Graph (num_vertices, directed, neighbors) so the
+//algorithms can take either one
+class CSRGraph {
+public:
+    struct InputEdge {
+        int u;
+        int v;
+        int weight;
+    };
+
+    CSRGraph() : n_(0), directed_(false), offsets_(1, 0) {}
+
+    //freeze an adjacency list graph, keeps per vertex edge order
+    explicit CSRGraph(const Graph& g)
+        : n_(g.num_vertices()), directed_(g.directed()), offsets_(g.num_vertices() + 1, 0) {
+        for (int u = 0; u < n_; ++u) {
+            offsets_[u + 1] = offsets_[u] + static_cast<long long>(g.neighbors(u).size());
+        }
+        edges_.reserve(static_cast<size_t>(offsets_[n_]));
+        for (int u = 0; u < n_; ++u) {
+            const auto& nbrs = g.neighbors(u);
+            edges_.insert(edges_.end(), nbrs.begin(), nbrs.end());
+        }
+    }
+
+    //build straight from an edge list with a counting sort on the source
+    //undirected graphs store every edge in both directions like Graph does
+    CSRGraph(int n, bool directed, const std::vector<InputEdge>& edges)
+        : n_(n), directed_(directed) {
+        if (n < 0) throw std::invalid_argument("CSRGraph: n must be >= 0");
+
+        offsets_.assign(n + 1, 0);
+        for (const auto& e : edges) {
+            if (e.u < 0 || e.u >= n || e.v < 0 || e.v >= n) {
+                throw std::out_of_range("CSRGraph: vertex out of range");
+            }
+            if (e.weight < 0) {
+                throw std::invalid_argument("CSRGraph: negative weights not allowed for Dijkstra");
+            }
+            offsets_[e.u + 1]++;
+            if (!directed) offsets_[e.v + 1]++;
+        }
+        for (int u = 0; u < n; ++u) {
+            offsets_[u + 1] += offsets_[u];
+        }
+
+        edges_.resize(static_cast<size_t>(offsets_[n]));
+        std::vector<long long> fill(offsets_.begin(), offsets_.end() - 1);
+        for (const auto& e : edges) {
+            edges_[fill[e.u]++] = {e.v, e.weight};
+            if (!directed) edges_[fill[e.v]++] = {e.u, e.weight};
+        }
+    }
+
+    //adopt already built arrays, used by generators that emit csr directly
+    CSRGraph(int n, bool directed, std::vector<long long> offsets, std::vector<Graph::Edge> edges)
+        : n_(n), directed_(directed), offsets_(std::move(offsets)), edges_(std::move(edges)) {
+        if (n < 0) throw std::invalid_argument("CSRGraph: n must be >= 0");
+        if (offsets_.size() != static_cast<size_t>(n) + 1 || offsets_[0] != 0 ||
+            offsets_[n] != static_cast<long long>(edges_.size())) {
+            throw std::invalid_argument("CSRGraph: offsets do not match edge array");
+        }
+    }
+
+    int num_vertices() const { return n_; }
+    bool directed() const { return directed_; }
+
+    //number of stored arcs, undirected edges are counted twice
+    long long num_arcs() const { return static_cast<long long>(edges_.size()); }
+
+    EdgeRange neighbors(int u) const {
+        if (u < 0 || u >= n_) throw std::out_of_range("CSRGraph::neighbors: vertex out of range");
+        const Graph::Edge* base = edges_.data();
+        return {base + offsets_[u], base + offsets_[u + 1]};
+    }
+
+    const std::vector<long long>& offsets() const { return offsets_; }
+    const std::vector<Graph::Edge>& edges() const { return edges_; }
+
+private:
+    int n_;
+    bool directed_;
+    std::vector<long long> offsets_;
+    std::vector<Graph::Edge> edges_;
+};
+
+#endif
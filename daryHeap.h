@@ -0,0 +1,231 @@
+//interfaces to priorityQueue.h
+
+#ifndef DARY_HEAP_H
+#define DARY_HEAP_H
+
+#include "priorityQueue.h"
+#include "nodePool.h"
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//the avx2 child search is compiled on any x86 gcc or clang build; without
+//-mavx2 it is built for avx2 on its own and picked at runtime
+#if defined(__AVX2__) || ((defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__))
+#define DARY_HEAP_AVX2 1
+#include <immintrin.h>
+#endif
+
+//handle given back by insert, pos is the slot in the heap arrays
+template<typename K, typename V>
+struct DaryNode : public Node<K,V> {
+    int pos;
+
+    DaryNode(K k, V v) : pos(-1) {
+        this->key = k;
+        this->value = v;
+    }
+};
+
+#if defined(DARY_HEAP_AVX2)
+//true if minOf8 can run here. a build with -mavx2 already assumes it,
+//otherwise the cpu is asked once at startup
+#if defined(__AVX2__)
+inline constexpr bool daryHeapAvx2 = true;
+#else
+inline const bool daryHeapAvx2 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+}();
+#endif
+
+//index of the smallest of 8 contiguous keys
+//two rounds of compare/blend on keys and indices, no branches
+__attribute__((target("avx2"))) inline int minOf8(const long long* keys) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + 4));
+    __m256i ia = _mm256_setr_epi64x(0, 1, 2, 3);
+    __m256i ib = _mm256_setr_epi64x(4, 5, 6, 7);
+
+    __m256i gt = _mm256_cmpgt_epi64(a, b);
+    __m256i m = _mm256_blendv_epi8(a, b, gt);
+    __m256i mi = _mm256_blendv_epi8(ia, ib, gt);
+
+    //compare lanes 0,1 against 2,3
+    __m256i m2 = _mm256_permute4x64_epi64(m, 0x4E);
+    __m256i mi2 = _mm256_permute4x64_epi64(mi, 0x4E);
+    gt = _mm256_cmpgt_epi64(m, m2);
+    m = _mm256_blendv_epi8(m, m2, gt);
+    mi = _mm256_blendv_epi8(mi, mi2, gt);
+
+    //compare lane 0 against 1
+    m2 = _mm256_permute4x64_epi64(m, 0xB1);
+    mi2 = _mm256_permute4x64_epi64(mi, 0xB1);
+    gt = _mm256_cmpgt_epi64(m, m2);
+    mi = _mm256_blendv_epi8(mi, mi2, gt);
+
+    return static_cast<int>(_mm256_extract_epi64(mi, 0));
+}
+#endif
+
+//indexed d-ary heap in flat arrays
+//keys_ and nodes_ are parallel, children of i are D*i+1 .. D*i+D
+//node->pos tracks where each handle sits so decrease_key can sift up from it
+//D = 8 with long long keys uses an avx2 min-of-children search on cpus that
+//have avx2, otherwise a plain loop. a build with -mavx2 (or -march=native)
+//inlines it, any other x86 build calls it after a runtime cpu check
+//structure stat (PQ_INSTRUMENT builds): levels moved by each sift down
+template<typename K, typename V, int D = 4>
+class DaryHeap final : public PriorityQueue<K,V> {
+    static_assert(D >= 2, "DaryHeap: arity must be at least 2");
+
+private:
+    std::vector<K> keys_;
+    std::vector<DaryNode<K,V>*> nodes_;
+    NodePool<DaryNode<K,V>> pool_;
+
+    void place(int i, K key, DaryNode<K,V>* node) {
+        keys_[i] = key;
+        nodes_[i] = node;
+        node->pos = i;
+    }
+
+    void siftUp(int i) {
+        K key = keys_[i];
+        DaryNode<K,V>* node = nodes_[i];
+
+        while (i > 0) {
+            int p = (i - 1) / D;
+            if (!(key < keys_[p])) break;
+            place(i, keys_[p], nodes_[p]);
+            i = p;
+        }
+        place(i, key, node);
+    }
+
+    //smallest child among the (up to D) children starting at first
+    int minChild(int first) const {
+        const int size = static_cast<int>(keys_.size());
+#if defined(DARY_HEAP_AVX2)
+        if constexpr (D == 8 && std::is_same<K, long long>::value) {
+            if (daryHeapAvx2 && first + 8 <= size) {
+                return first + minOf8(keys_.data() + first);
+            }
+        }
+#endif
+        int last = first + D < size ? first + D : size;
+        int best = first;
+        for (int c = first + 1; c < last; ++c) {
+            if (keys_[c] < keys_[best]) best = c;
+        }
+        return best;
+    }
+
+    void siftDown(int i) {
+        const int size = static_cast<int>(keys_.size());
+        K key = keys_[i];
+        DaryNode<K,V>* node = nodes_[i];
+
+        long long levels = 0;
+        while (true) {
+            long long first = static_cast<long long>(D) * i + 1;
+            if (first >= size) break;
+            int c = minChild(static_cast<int>(first));
+            if (!(keys_[c] < key)) break;
+            place(i, keys_[c], nodes_[c]);
+            i = c;
+            levels++;
+        }
+        place(i, key, node);
+        this->recordStructure(levels);
+    }
+
+    void releaseAll() {
+        if (!pool_.skipRelease()) {
+            for (DaryNode<K,V>* node : nodes_) pool_.release(node);
+        }
+        keys_.clear();
+        nodes_.clear();
+        pool_.reset();
+    }
+
+public:
+    explicit DaryHeap(bool pooled = true) : pool_(pooled) {}
+
+    ~DaryHeap() override {
+        if (!pool_.skipRelease()) {
+            for (DaryNode<K,V>* node : nodes_) pool_.release(node);
+        }
+    }
+
+    bool is_empty() override {
+        return keys_.empty();
+    }
+
+    void reset() override {
+        releaseAll();
+        this->resetCounters();
+    }
+
+    //times the system allocator was called for nodes
+    long long allocations() const { return pool_.allocations(); }
+
+    Node<K,V>* insert(K key, V value) override {
+        this->insertCount++;
+        OpTimer timer(this->insertHistogram());
+        DaryNode<K,V>* node = pool_.acquire(key, value);
+        keys_.push_back(key);
+        nodes_.push_back(node);
+        node->pos = static_cast<int>(keys_.size()) - 1;
+        siftUp(node->pos);
+        return node;
+    }
+
+    pair<K,V> find_min() override {
+        if (keys_.empty()) {
+            throw runtime_error("Heap is empty");
+        }
+        return {keys_[0], nodes_[0]->value};
+    }
+
+    pair<K,V> extract_min() override {
+        this->extractCount++;
+        OpTimer timer(this->extractHistogram());
+        if (keys_.empty()) {
+            throw runtime_error("Heap is empty");
+        }
+
+        DaryNode<K,V>* top = nodes_[0];
+        pair<K,V> result = {keys_[0], top->value};
+
+        K lastKey = keys_.back();
+        DaryNode<K,V>* lastNode = nodes_.back();
+        keys_.pop_back();
+        nodes_.pop_back();
+
+        if (!keys_.empty()) {
+            place(0, lastKey, lastNode);
+            siftDown(0);
+        }
+
+        pool_.release(top);
+        return result;
+    }
+
+    void decrease_key(Node<K,V>* node, K new_key) override {
+        this->decreaseKeyCount++;
+        OpTimer timer(this->decreaseKeyHistogram());
+        DaryNode<K,V>* x = static_cast<DaryNode<K,V>*>(node);
+
+        if (new_key > keys_[x->pos]) {
+            throw runtime_error("New key is greater than current key");
+        }
+
+        x->key = new_key;
+        keys_[x->pos] = new_key;
+        siftUp(x->pos);
+    }
+};
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include "dijkstra.h"
+#include "threadPool.h"
+
+#include <atomic>
+#include <climits>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+//bucket width that usually works: max weight over average out degree
+template<typename GraphT>
+inline long long suggestDelta(const GraphT& g) {
+    long long arcs = 0;
+    int maxW = 1;
+    for (int u = 0; u < g.num_vertices(); ++u) {
+        for (const auto& e : g.neighbors(u)) {
+            arcs++;
+            if (e.weight > maxW) maxW = e.weight;
+        }
+    }
+    if (arcs == 0) return 1;
+    double avgDegree = static_cast<double>(arcs) / g.num_vertices();
+    long long delta = static_cast<long long>(maxW / avgDegree);
+    return delta < 1 ? 1 : delta;
+}
+
+//parallel single source shortest paths (meyer and sanders delta stepping)
+//bucket i holds vertices with tentative distance in [i*delta, (i+1)*delta)
+//the lowest bucket is emptied by relaxing light edges (w <= delta) in parallel
+//until nothing lands in it again, then the heavy edges of everything settled
+//there are relaxed once. bucket contents are handed to threads in small
+//chunks on demand so a thread that runs out of work takes more
+//dist is identical to dijkstra(). when there are several shortest paths the
+//parent is the lowest numbered predecessor, so it can differ from dijkstra()
+//but is always a valid shortest path tree and does not depend on thread count
+template<typename GraphT>
+inline DijkstraResult delta_stepping(const GraphT& g, int source, long long delta, ThreadPool& pool) {
+    const int n = g.num_vertices();
+    if (source < 0 || source >= n) throw std::out_of_range("delta_stepping: source out of range");
+    if (delta < 1) throw std::invalid_argument("delta_stepping: delta must be >= 1");
+
+    const long long INF = std::numeric_limits<long long>::max() / 4;
+    const int threads = pool.size();
+    const size_t GRAIN = 64;
+
+    std::vector<std::atomic<long long>> dist(n);
+    for (int v = 0; v < n; ++v) dist[v].store(INF, std::memory_order_relaxed);
+
+    //distance a vertex was last queued with, stops the same entry going in twice
+    std::vector<long long> queued(n, INF);
+    std::vector<std::vector<int>> improved(threads);
+    std::map<long long, std::vector<int>> buckets;
+
+    dist[source].store(0, std::memory_order_relaxed);
+    queued[source] = 0;
+    buckets[0].push_back(source);
+
+    auto relax = [&](int v, long long nd, int tid) {
+        long long cur = dist[v].load(std::memory_order_relaxed);
+        while (nd < cur) {
+            if (dist[v].compare_exchange_weak(cur, nd, std::memory_order_relaxed)) {
+                improved[tid].push_back(v);
+                return;
+            }
+        }
+    };
+
+    //relax the light or heavy edges of every vertex in list
+    auto relaxAll = [&](const std::vector<int>& list, bool light) {
+        pool.parallel_for(list.size(), GRAIN, [&](size_t begin, size_t end, int tid) {
+            for (size_t i = begin; i < end; ++i) {
+                const int u = list[i];
+                const long long du = dist[u].load(std::memory_order_relaxed);
+                for (const auto& e : g.neighbors(u)) {
+                    if ((e.weight <= delta) != light) continue;
+                    relax(e.to, du + static_cast<long long>(e.weight), tid);
+                }
+            }
+        });
+    };
+
+    //move this round's improvements into their buckets
+    //ones that fall in the current bucket come back as the next frontier
+    auto collect = [&](long long current, std::vector<int>& frontier) {
+        frontier.clear();
+        for (auto& list : improved) {
+            for (int v : list) {
+                const long long dv = dist[v].load(std::memory_order_relaxed);
+                if (queued[v] == dv) continue;
+                queued[v] = dv;
+                const long long b = dv / delta;
+                if (b == current) {
+                    frontier.push_back(v);
+                } else {
+                    buckets[b].push_back(v);
+                }
+            }
+            list.clear();
+        }
+    };
+
+    std::vector<int> frontier;
+    std::vector<int> settled;
+    std::vector<long long> settledAt(n, -1);
+
+    while (!buckets.empty()) {
+        auto first = buckets.begin();
+        const long long current = first->first;
+
+        //drop entries whose vertex has since moved to a lower bucket
+        frontier.clear();
+        for (int v : first->second) {
+            if (dist[v].load(std::memory_order_relaxed) / delta == current) frontier.push_back(v);
+        }
+        buckets.erase(first);
+
+        settled.clear();
+        while (!frontier.empty()) {
+            for (int v : frontier) {
+                if (settledAt[v] != current) {
+                    settledAt[v] = current;
+                    settled.push_back(v);
+                }
+            }
+            relaxAll(frontier, true);
+            collect(current, frontier);
+        }
+
+        relaxAll(settled, false);
+        collect(current, frontier);
+    }
+
+    DijkstraResult res;
+    res.dist.resize(n);
+    for (int v = 0; v < n; ++v) res.dist[v] = dist[v].load(std::memory_order_relaxed);
+
+    //parent = lowest numbered u with a tight positive edge u -> v
+    std::vector<std::atomic<int>> parent(n);
+    for (int v = 0; v < n; ++v) parent[v].store(INT_MAX, std::memory_order_relaxed);
+
+    pool.parallel_for(n, 1024, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            const int u = static_cast<int>(i);
+            const long long du = res.dist[u];
+            if (du >= INF) continue;
+            for (const auto& e : g.neighbors(u)) {
+                const int v = e.to;
+                if (e.weight == 0 || v == source || du + e.weight != res.dist[v]) continue;
+                int cur = parent[v].load(std::memory_order_relaxed);
+                while (u < cur && !parent[v].compare_exchange_weak(cur, u, std::memory_order_relaxed)) {
+                }
+            }
+        }
+    });
+
+    res.parent.assign(n, -1);
+    bool missing = false;
+    for (int v = 0; v < n; ++v) {
+        const int p = parent[v].load(std::memory_order_relaxed);
+        if (p != INT_MAX) {
+            res.parent[v] = p;
+        } else if (v != source && res.dist[v] < INF) {
+            missing = true;
+        }
+    }
+
+    //vertices only reachable over tight zero weight edges, walk out from
+    //everything that already has a parent, in vertex order
+    if (missing) {
+        std::vector<int> queue;
+        std::vector<bool> done(n, false);
+        for (int v = 0; v < n; ++v) {
+            if (v == source || res.parent[v] != -1) {
+                done[v] = true;
+                queue.push_back(v);
+            }
+        }
+        for (size_t i = 0; i < queue.size(); ++i) {
+            const int u = queue[i];
+            for (const auto& e : g.neighbors(u)) {
+                const int v = e.to;
+                if (e.weight == 0 && !done[v] && res.dist[v] == res.dist[u]) {
+                    done[v] = true;
+                    res.parent[v] = u;
+                    queue.push_back(v);
+                }
+            }
+        }
+    }
+
+    return res;
+}
+
+//same thing with a pool made for this one call
+template<typename GraphT>
+inline DijkstraResult delta_stepping(const GraphT& g, int source, long long delta, int threads) {
+    ThreadPool pool(threads);
+    return delta_stepping(g, source, delta, pool);
+}
+
+#endif
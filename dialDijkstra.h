@@ -0,0 +1,88 @@
+#ifndef DIAL_DIJKSTRA_H
+#define DIAL_DIJKSTRA_H
+
+#include "dijkstra.h"
+#include "radixHeap.h"
+
+#include <vector>
+#include <limits>
+#include <stdexcept>
+
+//largest weight dial's algorithm will allocate buckets for
+const int DIAL_MAX_WEIGHT = 1 << 16;
+
+template<typename GraphT>
+inline int maxEdgeWeight(const GraphT& g) {
+    int maxW = 0;
+    for (int u = 0; u < g.num_vertices(); ++u) {
+        for (const auto& e : g.neighbors(u)) {
+            if (e.weight > maxW) maxW = e.weight;
+        }
+    }
+    return maxW;
+}
+
+//dijkstra for small integer weights with dial's circular buckets
+//maxWeight + 1 buckets are enough because every key in the queue is within
+//maxWeight of the one being settled, so each queue operation is O(1)
+//checks the weight range first (pass maxWeight if it is already known) and
+//falls back to dijkstra with a RadixHeap when it is above DIAL_MAX_WEIGHT
+template<typename GraphT>
+inline DijkstraResult dial_dijkstra(const GraphT& g, int source, int maxWeight = -1) {
+    const int n = g.num_vertices();
+    if (source < 0 || source >= n) throw std::out_of_range("dial_dijkstra: source out of range");
+
+    if (maxWeight < 0) maxWeight = maxEdgeWeight(g);
+    if (maxWeight > DIAL_MAX_WEIGHT) {
+        RadixHeap<int> pq;
+        return dijkstra(g, source, pq);
+    }
+
+    const long long INF = std::numeric_limits<long long>::max() / 4;
+    const int numBuckets = maxWeight + 1;
+
+    DijkstraResult res;
+    res.dist.assign(n, INF);
+    res.parent.assign(n, -1);
+
+    //a vertex is pushed again every time its distance drops
+    //stale copies are skipped when their bucket comes up
+    std::vector<std::vector<int>> buckets(numBuckets);
+    long long pending = 1;
+    long long cur = 0;
+
+    res.dist[source] = 0;
+    buckets[0].push_back(source);
+
+    while (pending > 0) {
+        std::vector<int>& bucket = buckets[cur % numBuckets];
+
+        //zero weight edges push into this bucket while it is being read
+        for (size_t i = 0; i < bucket.size(); ++i) {
+            const int u = bucket[i];
+            pending--;
+            if (res.dist[u] != cur) continue;
+
+            for (const auto& e : g.neighbors(u)) {
+                if (e.weight > maxWeight) {
+                    throw std::invalid_argument("dial_dijkstra: edge weight above maxWeight");
+                }
+                const int v = e.to;
+                const long long nd = cur + static_cast<long long>(e.weight);
+                if (nd < res.dist[v]) {
+                    res.dist[v] = nd;
+                    res.parent[v] = u;
+                    buckets[nd % numBuckets].push_back(v);
+                    pending++;
+                }
+            }
+        }
+
+        bucket.clear();
+        cur++;
+    }
+
+    return res;
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include "priorityQueue.h"
 
 #include <vector>
+#include <unordered_map>
 #include <limits>
 #include <stdexcept>
 #include <utility>
@@ -14,27 +15,54 @@ struct DijkstraResult {
     std::vector<int> parent; //predecessor on shortest path, -1 if none
 };
 
+//handle storage for dijkstra_into, kept between runs so repeated queries
+//reuse it instead of allocating a fresh handle vector every time
+template<typename PQ>
+struct DijkstraWorkspace {
+    using Handle = pq_handle_t<PQ, long long, int>;
+
+    //eager mode keeps one per vertex, lazy mode only the ones still in the heap
+    std::vector<Handle> handle;
+    std::unordered_map<int, Handle> frontier;
+};
+
 //single source shortest paths for non-negative weights
-inline DijkstraResult dijkstra(const Graph& g, int source, PriorityQueue<long long, int>& pq) {
+//GraphT is Graph or CSRGraph, anything with num_vertices() and neighbors(u)
+//PQ is PriorityQueue<long long, int> for runtime heap selection or a concrete
+//final heap type, in which case the heap calls are not virtual
+//lazyInsert only puts a vertex in the heap once an edge reaches it, for local
+//queries where most of the graph is never touched
+//writes into res and ws so their memory can be reused, pq must be empty
+template<typename GraphT, typename PQ>
+inline void dijkstra_into(const GraphT& g, int source, PQ& pq, DijkstraResult& res,
+                          DijkstraWorkspace<PQ>& ws, bool lazyInsert = false) {
+    static_assert(is_priority_queue<PQ, long long, int>::value,
+                  "dijkstra: PQ must provide the PriorityQueue operations");
+
     const int n = g.num_vertices();
     if (source < 0 || source >= n) throw std::out_of_range("dijkstra: source out of range");
 
     const long long INF = std::numeric_limits<long long>::max() / 4;
 
-    DijkstraResult res;
     res.dist.assign(n, INF);
     res.parent.assign(n, -1);
 
     //handles for decrease-key
-    std::vector<Node<long long, int>*> handle(n, nullptr);
-
-    //insert all vertices with INF then decrease source to 0
-    for (int v = 0; v < n; ++v) {
-        handle[v] = pq.insert(INF, v);
-    }
+    auto& handle = ws.handle;
+    auto& frontier = ws.frontier;
+    frontier.clear();
 
     res.dist[source] = 0;
-    pq.decrease_key(handle[source], 0);
+    if (lazyInsert) {
+        frontier.emplace(source, pq.insert(0, source));
+    } else {
+        //insert all vertices with INF then decrease source to 0
+        handle.assign(n, nullptr);
+        for (int v = 0; v < n; ++v) {
+            handle[v] = pq.insert(INF, v);
+        }
+        pq.decrease_key(handle[source], 0);
+    }
 
     while (!pq.is_empty()) {
         auto [du, u] = pq.extract_min();
@@ -42,6 +70,7 @@ inline DijkstraResult dijkstra(const Graph& g, int source, PriorityQueue<long lo
             //remaining vertices unreachable
             break;
         }
+        if (lazyInsert) frontier.erase(u);
 
         //relax edges
         for (const auto& e : g.neighbors(u)) {
@@ -50,11 +79,27 @@ inline DijkstraResult dijkstra(const Graph& g, int source, PriorityQueue<long lo
             if (nd < res.dist[v]) {
                 res.dist[v] = nd;
                 res.parent[v] = u;
-                pq.decrease_key(handle[v], nd);
+                if (!lazyInsert) {
+                    pq.decrease_key(handle[v], nd);
+                } else {
+                    auto it = frontier.find(v);
+                    if (it == frontier.end()) {
+                        frontier.emplace(v, pq.insert(nd, v));
+                    } else {
+                        pq.decrease_key(it->second, nd);
+                    }
+                }
             }
         }
     }
+}
 
+//same thing returning a fresh result
+template<typename GraphT, typename PQ>
+inline DijkstraResult dijkstra(const GraphT& g, int source, PQ& pq, bool lazyInsert = false) {
+    DijkstraResult res;
+    DijkstraWorkspace<PQ> ws;
+    dijkstra_into(g, source, pq, res, ws, lazyInsert);
     return res;
 }
 
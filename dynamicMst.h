@@ -0,0 +1,265 @@
+#ifndef DYNAMIC_MST_H
+#define DYNAMIC_MST_H
+
+#include "graph.h"
+#include "prim.h"
+#include "boruvka.h"
+#include "linkCutTree.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//an undirected weighted edge, for DynamicMST::apply and DynamicMST::edges
+struct MstEdge {
+    int u;
+    int v;
+    int weight;
+};
+
+//minimum spanning forest kept up to date while edges are added
+//the forest lives in a link cut tree where every forest edge is a node of its
+//own holding the weight. a new edge u - v either joins two trees, or closes
+//a cycle with the forest path u .. v, and then the heaviest edge on that
+//cycle is the one to drop: path_max finds it and, if it is heavier than the
+//new edge, one cut and one link swap them. O(log n) amortized per insert
+//components only ever merge, so a union find answers connectivity
+//updates go through this class, which changes the graph and the forest
+//together. the graph must not be changed behind its back
+class DynamicMST {
+public:
+    //starts from boruvka_mst, which spans every component
+    explicit DynamicMST(Graph& g)
+        : DynamicMST(g, g.num_vertices() == 0 ? PrimResult() : boruvka_mst(g, 0, 1)) {}
+
+    //starts from a forest already computed for g, by prim_mst on a connected
+    //graph or by boruvka_mst on any graph
+    //the forest has to span every component of g, otherwise it would not
+    //stay minimal and connected(u, v) would be wrong. prim_mst on a
+    //disconnected graph only covers start's component, so an edge of g
+    //between two of the forest's trees throws invalid_argument
+    DynamicMST(Graph& g, const PrimResult& forest) : g_(g) {
+        const int n = g_.num_vertices();
+        if (g_.directed()) throw std::invalid_argument("DynamicMST: requires an undirected graph");
+        if (static_cast<int>(forest.parent.size()) != n || static_cast<int>(forest.key.size()) != n) {
+            throw std::invalid_argument("DynamicMST: forest does not match the graph");
+        }
+        load(forest.parent, forest.key);
+        for (int u = 0; u < n; ++u) {
+            for (const auto& e : g_.neighbors(u)) {
+                if (find(u) != find(e.to)) {
+                    throw std::invalid_argument("DynamicMST: forest does not span every component of the graph");
+                }
+            }
+        }
+    }
+
+    //both O(1)
+    long long total_weight() const { return total_; }
+    int components() const { return components_; }
+
+    //true if the graph is connected
+    bool connected() const { return components_ <= 1; }
+    //near O(1), one union find lookup per vertex
+    bool connected(int u, int v) {
+        const int n = g_.num_vertices();
+        if (u < 0 || u >= n || v < 0 || v >= n) throw std::out_of_range("DynamicMST::connected: vertex out of range");
+        return find(u) == find(v);
+    }
+
+    int num_edges() const { return g_.num_vertices() - components_; }
+
+    //the forest edges, in no particular order
+    std::vector<MstEdge> edges() const {
+        std::vector<MstEdge> out;
+        out.reserve(num_edges());
+        for (size_t i = 0; i < edgeU_.size(); ++i) {
+            if (edgeU_[i] >= 0) out.push_back({edgeU_[i], edgeV_[i], weight(static_cast<int>(i))});
+        }
+        return out;
+    }
+
+    //adds u - v to the graph, true if it went into the forest
+    bool add_edge(int u, int v, int w) {
+        g_.add_edge(u, v, w);
+        return insert(u, v, w);
+    }
+
+    //every edge goes into the graph first, then the forest takes them all
+    //a batch of more than n / REBUILD_FRACTION edges is cheaper as one
+    //kruskal over the forest plus the batch than as that many inserts, the
+    //new forest is the minimum of the old one and the new edges together
+    //if an edge throws, the ones before it are still applied
+    void apply(const std::vector<MstEdge>& batch) {
+        std::vector<MstEdge> added;
+        added.reserve(batch.size());
+        try {
+            for (const MstEdge& e : batch) {
+                g_.add_edge(e.u, e.v, e.weight);
+                added.push_back(e);
+            }
+        } catch (...) {
+            merge(added);
+            throw;
+        }
+        merge(added);
+    }
+
+private:
+    static constexpr int REBUILD_FRACTION = 8;
+
+    Graph& g_;
+    LinkCutTree lct_;              //vertices 0 .. n-1, edge slot i is node n + i
+    std::vector<int> edgeU_;       //-1 for a free slot
+    std::vector<int> edgeV_;
+    std::vector<int> freeSlots_;
+    std::vector<int> uf_;          //union find parent, a root holds -size
+    long long total_ = 0;
+    int components_ = 0;
+
+    int weight(int slot) const { return static_cast<int>(lct_.weight(g_.num_vertices() + slot)); }
+
+    int find(int x) {
+        while (uf_[x] >= 0) {
+            if (uf_[uf_[x]] >= 0) uf_[x] = uf_[uf_[x]];
+            x = uf_[x];
+        }
+        return x;
+    }
+
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (uf_[a] > uf_[b]) std::swap(a, b);
+        uf_[a] += uf_[b];
+        uf_[b] = a;
+        components_--;
+        return true;
+    }
+
+    //fresh link cut tree and union find from a rooted forest
+    void load(const std::vector<int>& parent, const std::vector<long long>& key) {
+        const int n = g_.num_vertices();
+        //a forest has at most n - 1 edges, so n slots never run out
+        lct_.assign(2 * n);
+        edgeU_.assign(n, -1);
+        edgeV_.assign(n, -1);
+        freeSlots_.clear();
+        uf_.assign(n, -1);
+        total_ = 0;
+        components_ = n;
+
+        int slot = 0;
+        for (int v = 0; v < n; ++v) {
+            const int p = parent[v];
+            if (p < 0) continue;
+            if (p >= n || !unite(v, p)) throw std::invalid_argument("DynamicMST: forest parents do not form a forest");
+            const int x = n + slot;
+            lct_.set_weight(x, key[v]);
+            lct_.set_parent(v, x);
+            lct_.set_parent(x, p);
+            edgeU_[slot] = v;
+            edgeV_[slot] = p;
+            total_ += key[v];
+            slot++;
+        }
+        for (int i = n - 1; i >= slot; --i) freeSlots_.push_back(i);
+    }
+
+    void link(int u, int v, int w) {
+        const int slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        const int x = g_.num_vertices() + slot;
+        lct_.set_weight(x, w);
+        lct_.link(u, x);
+        lct_.link(x, v);
+        edgeU_[slot] = u;
+        edgeV_[slot] = v;
+        total_ += w;
+    }
+
+    void cut(int x) {
+        const int slot = x - g_.num_vertices();
+        total_ -= lct_.weight(x);
+        lct_.cut(edgeU_[slot], x);
+        lct_.cut(x, edgeV_[slot]);
+        edgeU_[slot] = -1;
+        edgeV_[slot] = -1;
+        freeSlots_.push_back(slot);
+    }
+
+    bool insert(int u, int v, int w) {
+        if (u == v) return false;
+        if (unite(u, v)) {
+            link(u, v, w);
+            return true;
+        }
+        //u .. v is a forest path, and vertex nodes weigh less than any edge
+        const int heaviest = lct_.path_max(u, v);
+        if (lct_.weight(heaviest) <= w) return false;
+        cut(heaviest);
+        link(u, v, w);
+        return true;
+    }
+
+    void merge(const std::vector<MstEdge>& added) {
+        const int n = g_.num_vertices();
+        if (static_cast<long long>(added.size()) * REBUILD_FRACTION <= n) {
+            for (const MstEdge& e : added) insert(e.u, e.v, e.weight);
+            return;
+        }
+
+        //kruskal over the forest and the batch
+        std::vector<MstEdge> candidates = edges();
+        candidates.insert(candidates.end(), added.begin(), added.end());
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const MstEdge& a, const MstEdge& b) { return a.weight < b.weight; });
+        uf_.assign(n, -1);
+        components_ = n;
+        std::vector<int> offsets(n + 1, 0);
+        std::vector<MstEdge> kept;
+        kept.reserve(n);
+        for (const MstEdge& e : candidates) {
+            if (!unite(e.u, e.v)) continue;
+            kept.push_back(e);
+            offsets[e.u + 1]++;
+            offsets[e.v + 1]++;
+        }
+
+        //root every tree and hand the parents to load
+        for (int v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+        std::vector<std::pair<int, int>> adj(offsets[n]);
+        std::vector<int> fillAt(offsets.begin(), offsets.end() - 1);
+        for (const MstEdge& e : kept) {
+            adj[fillAt[e.u]++] = {e.v, e.weight};
+            adj[fillAt[e.v]++] = {e.u, e.weight};
+        }
+        std::vector<int> parent(n, -1);
+        std::vector<long long> key(n, 0);
+        std::vector<char> seen(n, 0);
+        std::vector<int> queue;
+        queue.reserve(n);
+        for (int r = 0; r < n; ++r) {
+            if (seen[r]) continue;
+            seen[r] = 1;
+            queue.clear();
+            queue.push_back(r);
+            for (size_t i = 0; i < queue.size(); ++i) {
+                const int u = queue[i];
+                for (int a = offsets[u]; a < offsets[u + 1]; ++a) {
+                    const int v = adj[a].first;
+                    if (seen[v]) continue;
+                    seen[v] = 1;
+                    parent[v] = u;
+                    key[v] = adj[a].second;
+                    queue.push_back(v);
+                }
+            }
+        }
+        load(parent, key);
+    }
+};
+
+#endif
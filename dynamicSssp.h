@@ -0,0 +1,122 @@
+#ifndef DYNAMIC_SSSP_H
+#define DYNAMIC_SSSP_H
+
+#include "graph.h"
+#include "dijkstra.h"
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+//one change to the graph for DynamicSSSP::apply
+struct EdgeUpdate {
+    enum Kind { INSERT, DECREASE };
+
+    Kind kind;
+    int u;
+    int v;
+    int weight;
+};
+
+//single source shortest paths kept up to date while edges are added and
+//weights go down
+//distances can only shrink under these updates, so nothing has to be undone:
+//an update u -> v that gives v a shorter path seeds v in the heap, and a
+//dijkstra from the seeds carries the improvement on until it stops paying
+//the work is proportional to the vertices whose distance changed and their
+//edges, not to the size of the graph
+//updates go through this class, which changes the graph and repairs the
+//result together. the graph must not be changed behind its back
+template<typename PQ>
+class DynamicSSSP {
+public:
+    DynamicSSSP(Graph& g, int source) : g_(g), source_(source), settled_(0) {
+        PQ pq;
+        DijkstraWorkspace<PQ> ws;
+        dijkstra_into(g_, source_, pq, res_, ws);
+        handle_.assign(g_.num_vertices(), nullptr);
+    }
+
+    const DijkstraResult& result() const { return res_; }
+    int source() const { return source_; }
+
+    //vertices the last update or batch settled
+    long long settled() const { return settled_; }
+
+    void add_edge(int u, int v, int w) {
+        g_.add_edge(u, v, w);
+        pq_.reset();
+        seed(u, v, w);
+        propagate();
+    }
+
+    //false if the edge was already that light, nothing changes then
+    bool decrease_weight(int u, int v, int w) {
+        if (!g_.decrease_weight(u, v, w)) return false;
+        pq_.reset();
+        seed(u, v, w);
+        propagate();
+        return true;
+    }
+
+    //every update goes into the graph first, then one repair covers them
+    //all, so a vertex improved by several of them is settled once
+    //if an update throws, the ones before it are still applied and repaired
+    void apply(const std::vector<EdgeUpdate>& updates) {
+        pq_.reset();
+        try {
+            for (const EdgeUpdate& up : updates) {
+                if (up.kind == EdgeUpdate::INSERT) {
+                    g_.add_edge(up.u, up.v, up.weight);
+                } else if (!g_.decrease_weight(up.u, up.v, up.weight)) {
+                    continue;
+                }
+                seed(up.u, up.v, up.weight);
+            }
+        } catch (...) {
+            propagate();
+            throw;
+        }
+        propagate();
+    }
+
+private:
+    using Handle = pq_handle_t<PQ, long long, int>;
+
+    Graph& g_;
+    int source_;
+    DijkstraResult res_;
+    PQ pq_;
+    std::vector<Handle> handle_;  //null unless the vertex is in pq_
+    long long settled_;
+
+    void improve(int v, long long d, int from) {
+        if (d >= res_.dist[v]) return;
+        res_.dist[v] = d;
+        res_.parent[v] = from;
+        if (handle_[v] == nullptr) {
+            handle_[v] = pq_.insert(d, v);
+        } else {
+            pq_.decrease_key(handle_[v], d);
+        }
+    }
+
+    //the new edge u -> v (and v -> u if undirected) as a relaxation
+    void seed(int u, int v, int w) {
+        const long long INF = std::numeric_limits<long long>::max() / 4;
+        if (res_.dist[u] < INF) improve(v, res_.dist[u] + w, u);
+        if (!g_.directed() && res_.dist[v] < INF) improve(u, res_.dist[v] + w, v);
+    }
+
+    void propagate() {
+        settled_ = 0;
+        while (!pq_.is_empty()) {
+            auto [du, u] = pq_.extract_min();
+            handle_[u] = nullptr;
+            settled_++;
+            for (const auto& e : g_.neighbors(u)) improve(e.to, du + static_cast<long long>(e.weight), u);
+        }
+    }
+};
+
+#endif
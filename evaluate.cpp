@@ -1,80 +1,94 @@
 #include <iostream>
 #include <chrono>
 #include <string>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <type_traits>
+#include <cstdio>
+#include <climits>
+#include <memory>
+#include <optional>
+#include <filesystem>
+#include <algorithm>
 
 #include "graph.h"
+#include "csrGraph.h"
 #include "graphGenerator.h"
 #include "dijkstra.h"
 #include "prim.h"
-#include "fibonacciHeap.h"
-#include "pairingHeap.h"
+#include "heapSelect.h"
+#include "dialDijkstra.h"
+#include "deltaStepping.h"
+#include "boruvka.h"
+#include "batchQuery.h"
+#include "graphFile.h"
+#include "benchmark.h"
+#include "perfCounters.h"
+#include "pointToPoint.h"
+#include "astar.h"
+#include "contractionHierarchy.h"
+#include "landmarks.h"
+#include "dynamicSssp.h"
+#include "dynamicMst.h"
+#include "vertexOrder.h"
 
 using namespace std;
 
 struct BenchResult {
     double time_ms;
-    int inserts;
-    int extracts;
-    int decreaseKeys;
+    long long inserts;
+    long long extracts;
+    long long decreaseKeys;
+    PerfSample perf;  //only filled when counters were passed in
+    HeapStats stats;  //only filled in PQ_INSTRUMENT builds
 };
 
-//run dijkstra and time it
-//pass "fibonacci" or "pairing" for heapType
-BenchResult runDijkstra(const Graph& g, int source, const string& heapType) {
+//run dijkstra and time it, counters (optional) are read around the same call
+template<typename GraphT>
+BenchResult runDijkstra(const GraphT& g, int source, const string& heapType, PerfCounters* counters = nullptr) {
     BenchResult res;
 
-    if (heapType == "fibonacci") {
-        FibonacciHeap<long long, int> pq;
+    withHeap(heapType, [&](auto& pq) {
+        if (counters) counters->start();
         auto start = chrono::high_resolution_clock::now();
         dijkstra(g, source, pq);
         auto end = chrono::high_resolution_clock::now();
+        if (counters) res.perf = counters->stop();
         res.time_ms = chrono::duration<double, milli>(end - start).count();
         res.inserts = pq.insertCount;
         res.extracts = pq.extractCount;
         res.decreaseKeys = pq.decreaseKeyCount;
-    } else {
-        PairingHeap<long long, int> pq;
-        auto start = chrono::high_resolution_clock::now();
-        dijkstra(g, source, pq);
-        auto end = chrono::high_resolution_clock::now();
-        res.time_ms = chrono::duration<double, milli>(end - start).count();
-        res.inserts = pq.insertCount;
-        res.extracts = pq.extractCount;
-        res.decreaseKeys = pq.decreaseKeyCount;
-    }
+        if (pq.stats()) res.stats = *pq.stats();
+    });
 
     return res;
 }
 
 //same thing but for prim
-BenchResult runPrim(const Graph& g, int source, const string& heapType) {
+template<typename GraphT>
+BenchResult runPrim(const GraphT& g, int source, const string& heapType, PerfCounters* counters = nullptr) {
     BenchResult res;
 
-    if (heapType == "fibonacci") {
-        FibonacciHeap<long long, int> pq;
-        auto start = chrono::high_resolution_clock::now();
-        prim_mst(g, source, pq);
-        auto end = chrono::high_resolution_clock::now();
-        res.time_ms = chrono::duration<double, milli>(end - start).count();
-        res.inserts = pq.insertCount;
-        res.extracts = pq.extractCount;
-        res.decreaseKeys = pq.decreaseKeyCount;
-    } else {
-        PairingHeap<long long, int> pq;
+    withHeap(heapType, [&](auto& pq) {
+        if (counters) counters->start();
         auto start = chrono::high_resolution_clock::now();
         prim_mst(g, source, pq);
         auto end = chrono::high_resolution_clock::now();
+        if (counters) res.perf = counters->stop();
         res.time_ms = chrono::duration<double, milli>(end - start).count();
         res.inserts = pq.insertCount;
         res.extracts = pq.extractCount;
         res.decreaseKeys = pq.decreaseKeyCount;
-    }
+        if (pq.stats()) res.stats = *pq.stats();
+    });
 
     return res;
 }
 
 //count edges, undirected edges get counted twice so divide by 2
-int countEdges(const Graph& g, bool directed) {
+template<typename GraphT>
+int countEdges(const GraphT& g, bool directed) {
     int total = 0;
     for (int i = 0; i < g.num_vertices(); i++) {
         total += g.neighbors(i).size();
@@ -82,54 +96,1477 @@ int countEdges(const Graph& g, bool directed) {
     return directed ? total : total / 2;
 }
 
-int main() {
-    //csv header
-    cout << "algorithm,heap,graph_type,n,edges,time_ms,inserts,extracts,decrease_keys" << endl;
+//--size when given, otherwise the suite's own sizes
+vector<int> sizesOr(const BenchOptions& opts, const vector<int>& defaults) {
+    return opts.sizes.empty() ? defaults : opts.sizes;
+}
 
-    vector<int> sizes = {1000, 5000, 10000, 50000};
-    vector<string> heaps = {"fibonacci", "pairing"};
+//--heap when given, otherwise the suite's own heaps
+vector<string> heapsOr(const BenchOptions& opts, const vector<string>& defaults) {
+    return opts.heaps.empty() ? defaults : opts.heaps;
+}
+
+//one source per run, warmup included, drawn from opts.seed so every variant
+//measured on a graph starts from the same ones
+vector<int> pickSources(int n, const BenchOptions& opts) {
+    mt19937_64 rng(opts.seed);
+    uniform_int_distribution<int> pick(0, n - 1);
+    vector<int> sources(opts.warmup + opts.reps);
+    for (int& s : sources) s = pick(rng);
+    return sources;
+}
+
+//count source/target pairs drawn from opts.seed, the same batch every run
+vector<pair<int, int>> pickPairs(int n, int count, const BenchOptions& opts) {
+    mt19937_64 rng(opts.seed);
+    uniform_int_distribution<int> pick(0, n - 1);
+    vector<pair<int, int>> pairs(count);
+    for (auto& [s, t] : pairs) {
+        s = pick(rng);
+        t = pick(rng);
+    }
+    return pairs;
+}
+
+//adjacency list vs csr on the same graph, same heap and sources
+//the two layouts take turns going first, speedup is adj over csr by median
+template<typename Runner>
+void compareLayouts(BenchWriter& out, const BenchOptions& opts, const string& algo, const string& heap,
+                    const string& graphType, const Graph& g, Runner run) {
+    CSRGraph csr(g);
+    vector<int> sources = pickSources(g.num_vertices(), opts);
+    auto [adj, flat] = repeatPair(opts, [&](int i) { return run(g, sources[i]).time_ms; },
+                                  [&](int i) { return run(csr, sources[i]).time_ms; });
+
+    BenchRecord rec;
+    rec.add("algorithm", algo).add("heap", heap).add("graph_type", graphType)
+       .add("n", g.num_vertices()).add("edges", countEdges(g, g.directed()))
+       .add("warmup", opts.warmup).add("reps", opts.reps);
+    addTiming(rec, "adj_", adj);
+    addTiming(rec, "csr_", flat);
+    rec.add("speedup", adj.median / flat.median);
+    out.write(rec);
+}
+
+//takes the same flags as matrix, --gen picks from sparse, dense and grid
+void layoutSuite(const BenchOptions& opts) {
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {10000, 50000, 200000})) {
+        int gridSide = static_cast<int>(sqrt(n));
 
-    for (int n : sizes) {
         //need directed for dijkstra and undirected for prim
-        Graph sparseDi = generateRandom(n, true, 3 * n);
-        Graph denseDi = generateRandom(n, true, n * n / 4);
+        for (const string& algo : {string("dijkstra"), string("prim")}) {
+            if (!opts.wants(opts.algorithms, algo)) continue;
+            bool directed = algo == "dijkstra";
+
+            vector<pair<string, Graph>> graphs;
+            if (opts.wants(opts.generators, "sparse")) graphs.push_back({"sparse", generateRandom(n, directed, 3 * n)});
+            //dense n*n/4 gets too big past 10k so only sparse and grid go higher
+            if (n <= 10000 && opts.wants(opts.generators, "dense")) {
+                graphs.push_back({"dense", generateRandom(n, directed, n * n / 4)});
+            }
+            if (opts.wants(opts.generators, "grid")) graphs.push_back({"grid", generateGrid(gridSide, gridSide, directed)});
+
+            for (const string& heap : heapsOr(opts, {"fibonacci", "pairing"})) {
+                //radix is monotone, prim's keys are not
+                if (algo == "prim" && heap == "radix") continue;
+                for (const auto& [type, g] : graphs) {
+                    compareLayouts(out, opts, algo, heap, type, g, [&](const auto& graph, int s) {
+                        return directed ? runDijkstra(graph, s, heap) : runPrim(graph, s, heap);
+                    });
+                }
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//back to back dijkstra queries through one heap, reset() between them
+//a run is the whole batch of sources, allocations are only counted over the
+//timed runs, so a pooled heap that kept its nodes from the warmup shows none
+template<typename Heap>
+void poolingRow(BenchWriter& out, const BenchOptions& opts, const string& heapName, bool pooled,
+                const string& graphType, const Graph& g, const vector<int>& sources) {
+    Heap pq(pooled);
+    long long before = 0;
+    SampleStats st = repeatRuns(opts, [&](int i) {
+        if (i == opts.warmup) before = pq.allocations();
+        return timeMs([&] {
+            for (int s : sources) {
+                pq.reset();
+                dijkstra(g, s, pq);
+            }
+        });
+    });
+    double allocs = static_cast<double>(pq.allocations() - before) / opts.reps;
+
+    BenchRecord rec;
+    rec.add("heap", heapName).add("mode", pooled ? "pooled" : "unpooled").add("graph_type", graphType)
+       .add("n", g.num_vertices()).add("queries", static_cast<long long>(sources.size()))
+       .add("warmup", opts.warmup).add("reps", opts.reps);
+    addTiming(rec, "", st);
+    rec.add("ms_per_query", st.median / sources.size())
+       .add("allocations", allocs).add("allocs_per_query", allocs / sources.size());
+    out.write(rec);
+}
+
+//takes the same flags as matrix, --gen picks from sparse and grid
+void poolingSuite(const BenchOptions& opts) {
+    const int queries = 100;
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {10000})) {
         int gridSide = static_cast<int>(sqrt(n));
-        Graph gridDi = generateGrid(gridSide, gridSide, true);
+        vector<pair<string, Graph>> graphs;
+        if (opts.wants(opts.generators, "sparse")) graphs.push_back({"sparse", generateRandom(n, true, 3 * n)});
+        if (opts.wants(opts.generators, "grid")) graphs.push_back({"grid", generateGrid(gridSide, gridSide, true)});
+
+        for (const auto& [type, g] : graphs) {
+            mt19937_64 rng(opts.seed);
+            uniform_int_distribution<int> pick(0, g.num_vertices() - 1);
+            vector<int> sources(queries);
+            for (int& s : sources) s = pick(rng);
+
+            for (const string& heap : heapsOr(opts, {"fibonacci", "pairing"})) {
+                withHeapType(heap, [&](auto tag) {
+                    using PQ = typename decltype(tag)::type;
+                    for (bool pooled : {false, true}) poolingRow<PQ>(out, opts, heap, pooled, type, g, sources);
+                });
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//same heap type run through the PriorityQueue base (virtual calls) and as
+//its concrete type (direct calls the compiler can inline)
+//each mode has its own heap, both are warmed up with opts.warmup runs so the
+//node slabs are already there, and the modes take turns going first so
+//neither always inherits the other's cache state
+template<typename Heap, typename GraphT>
+void dispatchCell(BenchWriter& out, const BenchOptions& opts, const string& algo, const string& heapName,
+                  const string& graphType, const GraphT& g) {
+    Heap virtHeap;
+    Heap staticHeap;
+    PriorityQueue<long long, int>& base = virtHeap;
 
+    auto runVirtual = [&](int) {
+        virtHeap.reset();
+        return timeMs([&] {
+            if (algo == "dijkstra") dijkstra(g, 0, base);
+            else prim_mst(g, 0, base);
+        });
+    };
+    auto runStatic = [&](int) {
+        staticHeap.reset();
+        return timeMs([&] {
+            if (algo == "dijkstra") dijkstra(g, 0, staticHeap);
+            else prim_mst(g, 0, staticHeap);
+        });
+    };
+    auto [virt, stat] = repeatPair(opts, runVirtual, runStatic);
+
+    BenchRecord rec;
+    rec.add("algorithm", algo).add("heap", heapName).add("graph_type", graphType)
+       .add("n", g.num_vertices()).add("warmup", opts.warmup).add("reps", opts.reps);
+    addTiming(rec, "virtual_", virt);
+    addTiming(rec, "static_", stat);
+    rec.add("speedup", virt.median / stat.median);
+    out.write(rec);
+}
+
+template<typename Heap>
+void dispatchRows(BenchWriter& out, const BenchOptions& opts, const string& heapName, const string& graphType,
+                  const Graph& dg, const Graph& ug) {
+    if (!opts.wants(opts.heaps, heapName) || !opts.wants(opts.generators, graphType)) return;
+    if (opts.wants(opts.algorithms, "dijkstra")) dispatchCell<Heap>(out, opts, "dijkstra", heapName, graphType, dg);
+    if (opts.wants(opts.algorithms, "prim")) dispatchCell<Heap>(out, opts, "prim", heapName, graphType, ug);
+}
+
+//takes the same flags as matrix, --gen picks from sparse and grid
+void dispatchSuite(const BenchOptions& opts) {
+    vector<int> sizes = sizesOr(opts, {10000, 50000, 200000});
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizes) {
+        int gridSide = static_cast<int>(sqrt(n));
+        Graph sparseDi = generateRandom(n, true, 3 * n);
         Graph sparseUn = generateRandom(n, false, 3 * n);
-        Graph denseUn = generateRandom(n, false, n * n / 4);
+        Graph gridDi = generateGrid(gridSide, gridSide, true);
         Graph gridUn = generateGrid(gridSide, gridSide, false);
 
-        //dijkstra tests
-        for (const string& heap : heaps) {
-            BenchResult r;
+        dispatchRows<FibonacciHeap<long long, int>>(out, opts, "fibonacci", "sparse", sparseDi, sparseUn);
+        dispatchRows<FibonacciHeap<long long, int>>(out, opts, "fibonacci", "grid", gridDi, gridUn);
+        dispatchRows<PairingHeap<long long, int>>(out, opts, "pairing", "sparse", sparseDi, sparseUn);
+        dispatchRows<PairingHeap<long long, int>>(out, opts, "pairing", "grid", gridDi, gridUn);
+        dispatchRows<DaryHeap<long long, int, 4>>(out, opts, "dary4", "sparse", sparseDi, sparseUn);
+        dispatchRows<DaryHeap<long long, int, 4>>(out, opts, "dary4", "grid", gridDi, gridUn);
+    }
+
+    out.finish();
+}
+
+//integer priority queues against the comparison heaps on dijkstra
+//dial is the bucket engine and can be asked for with --heap like a heap,
+//the rest go through dijkstra(). --gen picks from sparse, dense and grid
+void integerSuite(const BenchOptions& opts) {
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {1000, 5000, 10000, 50000})) {
+        int gridSide = static_cast<int>(sqrt(n));
+        vector<pair<string, Graph>> graphs;
+        if (opts.wants(opts.generators, "sparse")) graphs.push_back({"sparse", generateRandom(n, true, 3 * n)});
+        if (n <= 10000 && opts.wants(opts.generators, "dense")) {
+            graphs.push_back({"dense", generateRandom(n, true, n * n / 4)});
+        }
+        if (opts.wants(opts.generators, "grid")) graphs.push_back({"grid", generateGrid(gridSide, gridSide, true)});
+
+        for (const auto& [type, g] : graphs) {
+            int edges = countEdges(g, true);
+            int maxW = maxEdgeWeight(g);
+            vector<int> sources = pickSources(g.num_vertices(), opts);
+
+            for (const string& heap : heapsOr(opts, {"fibonacci", "pairing", "radix", "dial"})) {
+                SampleStats st = heap == "dial"
+                    ? repeatRuns(opts, [&](int i) { return timeMs([&] { dial_dijkstra(g, sources[i], maxW); }); })
+                    : repeatRuns(opts, [&](int i) { return runDijkstra(g, sources[i], heap).time_ms; });
+
+                BenchRecord rec;
+                rec.add("algorithm", "dijkstra").add("heap", heap).add("graph_type", type)
+                   .add("n", g.num_vertices()).add("edges", edges)
+                   .add("warmup", opts.warmup).add("reps", opts.reps);
+                addTiming(rec, "", st);
+                out.write(rec);
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//1, 2, 4, ... up to maxThreads, plus maxThreads itself
+vector<int> threadCounts(int maxThreads) {
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+//delta stepping from 1 to maxThreads threads against sequential dijkstra,
+//both timed over the same sources. --gen picks from sparse and grid
+//matches says whether every distance of every run agreed with dijkstra
+void scalingSuite(int maxThreads, const BenchOptions& opts) {
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {50000, 200000, 1000000})) {
+        int gridSide = static_cast<int>(sqrt(n));
+        vector<pair<string, Graph>> graphs;
+        if (opts.wants(opts.generators, "sparse")) graphs.push_back({"sparse", generateRandom(n, true, 3 * n)});
+        if (opts.wants(opts.generators, "grid")) graphs.push_back({"grid", generateGrid(gridSide, gridSide, true)});
+
+        for (const auto& [type, g] : graphs) {
+            vector<int> sources = pickSources(g.num_vertices(), opts);
+            vector<DijkstraResult> expected(sources.size());
+            PairingHeap<long long, int> pq;
+            SampleStats seq = repeatRuns(opts, [&](int i) {
+                pq.reset();
+                return timeMs([&] { expected[i] = dijkstra(g, sources[i], pq); });
+            });
+            long long delta = suggestDelta(g);
+            double oneThreadMs = 0;
+
+            for (int t : threadCounts(maxThreads)) {
+                ThreadPool pool(t);
+                bool matches = true;
+                SampleStats st = repeatRuns(opts, [&](int i) {
+                    DijkstraResult got;
+                    double ms = timeMs([&] { got = delta_stepping(g, sources[i], delta, pool); });
+                    matches = matches && got.dist == expected[i].dist;
+                    return ms;
+                });
+                if (t == 1) oneThreadMs = st.median;
+
+                BenchRecord rec;
+                rec.add("algorithm", "delta_stepping").add("graph_type", type).add("n", g.num_vertices())
+                   .add("edges", countEdges(g, true)).add("threads", t).add("delta", delta)
+                   .add("warmup", opts.warmup).add("reps", opts.reps);
+                addTiming(rec, "", st);
+                rec.add("dijkstra_median_ms", seq.median).add("speedup_vs_1_thread", oneThreadMs / st.median)
+                   .add("matches", matches ? "yes" : "no");
+                out.write(rec);
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//parallel boruvka from 1 to maxThreads threads against prim_mst, both timed
+//over the same start vertices. --size replaces both size lists, dense only
+//takes the sizes up to 10k. matches says whether every run's total weight
+//agreed with prim's, the generated graphs are connected so it does not
+//depend on the start
+void mstScalingSuite(int maxThreads, const BenchOptions& opts) {
+    BenchWriter out(cout, opts.format);
+
+    vector<pair<string, Graph>> graphs;
+    if (opts.wants(opts.generators, "sparse")) {
+        for (int n : sizesOr(opts, {50000, 200000, 1000000})) {
+            graphs.push_back({"sparse", generateRandom(n, false, 3 * n)});
+        }
+    }
+    if (opts.wants(opts.generators, "dense")) {
+        for (int n : sizesOr(opts, {2000, 5000})) {
+            if (n <= 10000) graphs.push_back({"dense", generateRandom(n, false, n * n / 4)});
+        }
+    }
+
+    for (const auto& [type, g] : graphs) {
+        vector<int> sources = pickSources(g.num_vertices(), opts);
+        PairingHeap<long long, int> pq;
+        long long expected = 0;
+        SampleStats prim = repeatRuns(opts, [&](int i) {
+            pq.reset();
+            return timeMs([&] { expected = prim_mst(g, sources[i], pq).total_weight; });
+        });
+        double oneThreadMs = 0;
+
+        for (int t : threadCounts(maxThreads)) {
+            ThreadPool pool(t);
+            bool matches = true;
+            SampleStats st = repeatRuns(opts, [&](int i) {
+                PrimResult got;
+                double ms = timeMs([&] { got = boruvka_mst(g, sources[i], pool); });
+                matches = matches && got.total_weight == expected;
+                return ms;
+            });
+            if (t == 1) oneThreadMs = st.median;
+
+            BenchRecord rec;
+            rec.add("algorithm", "boruvka").add("graph_type", type).add("n", g.num_vertices())
+               .add("edges", countEdges(g, false)).add("threads", t)
+               .add("warmup", opts.warmup).add("reps", opts.reps);
+            addTiming(rec, "", st);
+            rec.add("prim_median_ms", prim.median).add("speedup_vs_1_thread", oneThreadMs / st.median)
+               .add("matches", matches ? "yes" : "no");
+            out.write(rec);
+        }
+    }
+
+    out.finish();
+}
+
+//queries per second for a batch of random sources, per heap and thread count
+//a run is the whole batch, queries_per_sec comes from the median run
+//--gen picks from sparse and grid
+void throughputSuite(int maxThreads, const BenchOptions& opts) {
+    const int queries = 1000;
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {10000})) {
+        int gridSide = static_cast<int>(sqrt(n));
+        vector<pair<string, Graph>> graphs;
+        if (opts.wants(opts.generators, "sparse")) graphs.push_back({"sparse", generateRandom(n, true, 3 * n)});
+        if (opts.wants(opts.generators, "grid")) graphs.push_back({"grid", generateGrid(gridSide, gridSide, true)});
+
+        for (const auto& [type, g] : graphs) {
+            mt19937_64 rng(opts.seed);
+            uniform_int_distribution<int> pick(0, g.num_vertices() - 1);
+            vector<int> sources(queries);
+            for (int& s : sources) s = pick(rng);
+
+            for (const string& heap : heapsOr(opts, {"fibonacci", "pairing", "dary4", "radix"})) {
+                for (int t : threadCounts(maxThreads)) {
+                    ThreadPool pool(t);
+                    SampleStats st;
+
+                    //dijkstra_batch builds a heap per worker, only the type is needed
+                    withHeapType(heap, [&](auto tag) {
+                        using PQ = typename decltype(tag)::type;
+                        st = repeatRuns(opts, [&](int) {
+                            return timeMs([&] {
+                                dijkstra_batch<PQ>(g, sources, pool, [](size_t, int, const DijkstraResult&) {});
+                            });
+                        });
+                    });
+
+                    BenchRecord rec;
+                    rec.add("algorithm", "dijkstra_batch").add("heap", heap).add("graph_type", type)
+                       .add("n", g.num_vertices()).add("queries", queries).add("threads", t)
+                       .add("warmup", opts.warmup).add("reps", opts.reps);
+                    addTiming(rec, "", st);
+                    rec.add("queries_per_sec", queries / (st.median / 1000.0));
+                    out.write(rec);
+                }
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//generate vs write vs mmap open for the binary graph format, each repeated,
+//with the optional full verify() pass timed on its own. opens after the
+//first find the file in the page cache, file_mb is the real file size
+//then dijkstra on the mapped graph against the in memory csr copy, taking
+//turns going first. --gen picks from sparse and grid
+void ioSuite(const string& path, const BenchOptions& opts) {
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {1000000, 4000000})) {
+        int gridSide = static_cast<int>(sqrt(n));
+
+        for (const string& type : {string("sparse"), string("grid")}) {
+            if (!opts.wants(opts.generators, type)) continue;
+            Graph g;
+            SampleStats gen = repeatRuns(opts, [&](int) {
+                return timeMs([&] {
+                    g = type == "sparse" ? generateRandom(n, true, 3 * n) : generateGrid(gridSide, gridSide, true);
+                });
+            });
+            CSRGraph csr(g);
+
+            SampleStats write = repeatRuns(opts, [&](int) { return timeMs([&] { writeGraphFile(path, csr); }); });
+
+            optional<MappedGraph> mapped;
+            SampleStats open = repeatRuns(opts, [&](int) {
+                mapped.reset();
+                return timeMs([&] { mapped.emplace(path); });
+            });
+            SampleStats verify = repeatRuns(opts, [&](int) { return timeMs([&] { mapped->verify(); }); });
+
+            double fileMb = static_cast<double>(filesystem::file_size(path)) / (1024.0 * 1024.0);
+            vector<int> sources = pickSources(csr.num_vertices(), opts);
+            auto [inMemory, onDisk] = repeatPair(opts, [&](int i) { return runDijkstra(csr, sources[i], "pairing").time_ms; },
+                                                 [&](int i) { return runDijkstra(*mapped, sources[i], "pairing").time_ms; });
+
+            BenchRecord rec;
+            rec.add("graph_type", type).add("n", csr.num_vertices()).add("edges", csr.num_arcs())
+               .add("warmup", opts.warmup).add("reps", opts.reps);
+            addTiming(rec, "generate_", gen);
+            addTiming(rec, "write_", write);
+            addTiming(rec, "open_", open);
+            addTiming(rec, "verify_", verify);
+            rec.add("file_mb", fileMb);
+            addTiming(rec, "csr_dijkstra_", inMemory);
+            addTiming(rec, "mapped_dijkstra_", onDisk);
+            out.write(rec);
+
+            mapped.reset();
+            remove(path.c_str());
+        }
+    }
+
+    out.finish();
+}
+
+//old mt19937 generators building a Graph vs the counter based csr ones
+//--size replaces the default cases with sparse, dense (up to 10k) and grid at
+//each size, --gen picks from those three
+void generatorSuite(int maxThreads, const BenchOptions& opts) {
+    struct Case {
+        string type;
+        int n;
+        long long edges;
+    };
+    vector<Case> cases = {{"sparse", 200000, 600000}, {"sparse", 1000000, 3000000},
+                          {"dense", 2000, 1000000}, {"dense", 5000, 6250000},
+                          {"grid", 1000000, 0}, {"grid", 4000000, 0}};
+    if (!opts.sizes.empty()) {
+        cases.clear();
+        for (int n : opts.sizes) {
+            cases.push_back({"sparse", n, 3LL * n});
+            if (n <= 10000) cases.push_back({"dense", n, static_cast<long long>(n) * n / 4});
+            cases.push_back({"grid", n, 0});
+        }
+    }
+
+    BenchWriter out(cout, opts.format);
+
+    for (const Case& c : cases) {
+        if (!opts.wants(opts.generators, c.type)) continue;
+        int side = static_cast<int>(sqrt(c.n));
+        SampleStats old = repeatRuns(opts, [&](int) {
+            return timeMs([&] {
+                Graph g = c.type == "grid" ? generateGrid(side, side, false)
+                                           : generateRandom(c.n, false, static_cast<int>(c.edges));
+            });
+        });
+
+        for (int t : threadCounts(maxThreads)) {
+            long long arcs = 0;
+            SampleStats st = repeatRuns(opts, [&](int) {
+                return timeMs([&] {
+                    CSRGraph g = c.type == "grid" ? generateGridCSR(side, side, false, 1000, 42, t)
+                                                  : generateRandomCSR(c.n, false, c.edges, 1000, 67, t);
+                    arcs = g.num_arcs();
+                });
+            });
+
+            BenchRecord rec;
+            rec.add("generator", c.type == "grid" ? "generateGridCSR" : "generateRandomCSR").add("graph_type", c.type)
+               .add("n", c.type == "grid" ? side * side : c.n).add("edges", arcs / 2).add("threads", t)
+               .add("warmup", opts.warmup).add("reps", opts.reps);
+            addTiming(rec, "", st);
+            rec.add("old_median_ms", old.median).add("speedup", old.median / st.median);
+            out.write(rec);
+        }
+    }
+
+    out.finish();
+}
+
+//median of each counter over the runs, NA for counters that never opened
+//prefix goes in front of every column, for rows that hold several runs' counters
+void addPerfColumns(BenchRecord& rec, const vector<PerfSample>& runs, const string& prefix = "") {
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        vector<double> values;
+        for (const PerfSample& p : runs) {
+            if (p.valid[e]) values.push_back(static_cast<double>(p.value[e]));
+        }
+        if (values.empty()) {
+            rec.addMissing(prefix + perfEventName(e));
+        } else {
+            rec.add(prefix + perfEventName(e), summarize(values).median);
+        }
+    }
+
+    vector<double> ipc;
+    for (const PerfSample& p : runs) {
+        if (p.has(PERF_CYCLES) && p.has(PERF_INSTRUCTIONS)) ipc.push_back(p.ipc());
+    }
+    if (ipc.empty()) {
+        rec.addMissing(prefix + "ipc");
+    } else {
+        rec.add(prefix + "ipc", summarize(ipc).median);
+    }
+}
+
+//counters split between extract_min and insert/decrease_key for dijkstra
+//per heap, to see which phase the cache and branch misses come from
+//run i starts from sources[i], each counter is the median over the timed
+//runs. there are no time columns, the wrapper's syscalls swamp the time
+//takes the same flags as matrix, --gen picks from sparse and grid
+void phasesSuite(const BenchOptions& opts) {
+    if (!PerfCounters().available()) cerr << "hardware counters unavailable, their columns will be NA" << endl;
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {10000, 50000})) {
+        int gridSide = static_cast<int>(sqrt(n));
+        vector<pair<string, Graph>> graphs;
+        if (opts.wants(opts.generators, "sparse")) graphs.push_back({"sparse", generateRandom(n, true, 3 * n)});
+        if (opts.wants(opts.generators, "grid")) graphs.push_back({"grid", generateGrid(gridSide, gridSide, true)});
+
+        for (const auto& [type, g] : graphs) {
+            vector<int> sources = pickSources(g.num_vertices(), opts);
+
+            for (const string& heap : heapNames()) {
+                if (!opts.wants(opts.heaps, heap)) continue;
+                withHeap(heap, [&](auto& pq) {
+                    PerfPhaseHeap<typename std::decay<decltype(pq)>::type> phased(pq);
+                    vector<PerfSample> extract, update;
+                    for (int i = 0; i < opts.warmup + opts.reps; i++) {
+                        phased.reset();
+                        dijkstra(g, sources[i], phased);
+                        if (i < opts.warmup) continue;
+                        extract.push_back(phased.extractCounters());
+                        update.push_back(phased.updateCounters());
+                    }
+
+                    for (const string& phase : {string("extract"), string("update")}) {
+                        BenchRecord rec;
+                        rec.add("algorithm", "dijkstra").add("heap", heap).add("graph_type", type)
+                           .add("n", g.num_vertices()).add("phase", phase)
+                           .add("warmup", opts.warmup).add("reps", opts.reps);
+                        addPerfColumns(rec, phase == "extract" ? extract : update);
+                        out.write(rec);
+                    }
+                });
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//latency percentiles per operation and the heap's structure metric, over
+//every sampled call of every timed run
+void addHeapStatsColumns(BenchRecord& rec, const HeapStats& stats) {
+    const pair<const char*, const LatencyHistogram*> ops[] = {
+        {"insert", &stats.insert}, {"extract", &stats.extract}, {"decrease_key", &stats.decreaseKey}};
+    for (const auto& [name, hist] : ops) {
+        string prefix = name;
+        rec.add(prefix + "_p50_ns", static_cast<long long>(hist->percentile(0.5)))
+           .add(prefix + "_p99_ns", static_cast<long long>(hist->percentile(0.99)))
+           .add(prefix + "_max_ns", static_cast<long long>(hist->max()));
+    }
+    rec.add("structure_mean", stats.structure.mean()).add("structure_max", stats.structure.max);
+}
+
+//one cell of the matrix: opts.warmup runs that are thrown away, then
+//opts.reps timed runs, run i starting from sources[i]
+template<typename GraphT>
+void benchCell(BenchWriter& out, const BenchOptions& opts, PerfCounters* counters, const string& algo,
+               const string& heap, const string& graphType, const GraphT& g, int edges, const vector<int>& sources) {
+    vector<double> samples;
+    vector<PerfSample> perf;
+    HeapStats stats;
+    long long inserts = 0, extracts = 0, decreaseKeys = 0;
+
+    for (int i = 0; i < opts.warmup + opts.reps; i++) {
+        BenchResult r = algo == "dijkstra" ? runDijkstra(g, sources[i], heap, counters)
+                                           : runPrim(g, sources[i], heap, counters);
+        if (i < opts.warmup) continue;
+        samples.push_back(r.time_ms);
+        perf.push_back(r.perf);
+        stats.merge(r.stats);
+        inserts += r.inserts;
+        extracts += r.extracts;
+        decreaseKeys += r.decreaseKeys;
+    }
+
+    SampleStats st = summarize(samples);
+    BenchRecord rec;
+    rec.add("algorithm", algo).add("heap", heap).add("graph_type", graphType)
+       .add("n", g.num_vertices()).add("edges", edges)
+       .add("warmup", opts.warmup).add("reps", opts.reps);
+    addTiming(rec, "", st);
+    rec.add("inserts", static_cast<double>(inserts) / opts.reps)
+       .add("extracts", static_cast<double>(extracts) / opts.reps)
+       .add("decrease_keys", static_cast<double>(decreaseKeys) / opts.reps);
+    if (counters) addPerfColumns(rec, perf);
+    if (PQ_INSTRUMENTED) addHeapStatsColumns(rec, stats);
+    out.write(rec);
+}
+
+//every heap on every generator and size, filtered by opts
+//sources are drawn once per graph from opts.seed so every heap sees the same
+//ones, the graphs themselves always use the generators' default seeds
+void matrixSuite(const BenchOptions& opts) {
+    vector<int> sizes = sizesOr(opts, {1000, 5000, 10000, 50000});
+    const vector<string>& heaps = heapNames();
+    vector<string> generators = {"sparse", "dense", "grid", "worst"};
+
+    BenchWriter out(cout, opts.format);
+
+    //--perf 1 adds counter columns, NA where the machine has no such counter
+    unique_ptr<PerfCounters> counters;
+    if (opts.perf) {
+        counters.reset(new PerfCounters());
+        if (!counters->available()) cerr << "hardware counters unavailable, their columns will be NA" << endl;
+    }
+
+    for (int n : sizes) {
+        for (const string& gen : generators) {
+            if (!opts.wants(opts.generators, gen)) continue;
+            //dense n*n/4 gets too big past 10k
+            if (gen == "dense" && n > 10000) continue;
+
+            int gridSide = static_cast<int>(sqrt(n));
+            auto make = [&](bool directed) {
+                if (gen == "sparse") return generateRandom(n, directed, 3 * n);
+                if (gen == "dense") return generateRandom(n, directed, n * n / 4);
+                if (gen == "worst") return generateWorstCase(n, directed);
+                return generateGrid(gridSide, gridSide, directed);
+            };
+
+            //need directed for dijkstra and undirected for prim
+            for (const string& algo : {string("dijkstra"), string("prim")}) {
+                if (!opts.wants(opts.algorithms, algo)) continue;
+                bool directed = algo == "dijkstra";
+                Graph g = make(directed);
+                int edges = countEdges(g, directed);
+
+                vector<int> sources = pickSources(g.num_vertices(), opts);
+
+                for (const string& heap : heaps) {
+                    if (!opts.wants(opts.heaps, heap)) continue;
+                    //radix is monotone, prim's keys are not
+                    if (algo == "prim" && heap == "radix") continue;
+                    benchCell(out, opts, counters.get(), algo, heap, gen, g, edges, sources);
+                }
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//dense graphs only, where dijkstra and prim do far more decrease_keys than
+//extract_mins, so the heaps are compared on the operation they differ on most
+//takes the same flags as matrix, --gen is ignored. default heaps are the
+//pointer based ones plus dary4 as the array baseline
+void decreaseKeySuite(const BenchOptions& opts) {
+    vector<int> sizes = sizesOr(opts, {1000, 2000, 4000});
+    vector<string> heaps = heapsOr(opts, {"hollow", "fibonacci", "pairing", "pairing_aux", "rank_pairing", "dary4"});
+
+    BenchWriter out(cout, opts.format);
+    unique_ptr<PerfCounters> counters;
+    if (opts.perf) {
+        counters.reset(new PerfCounters());
+        if (!counters->available()) cerr << "hardware counters unavailable, their columns will be NA" << endl;
+    }
+
+    for (int n : sizes) {
+        //two thirds of all vertex pairs, the most generateRandom can fill
+        //without spending most of its time on rejected duplicates. its edge
+        //target is an int, which caps n a little under 80k
+        const long long target = static_cast<long long>(n) * (n - 1) / 3;
+        if (n < 2 || target > INT_MAX) {
+            cerr << "decrease_key: size " << n << " is out of range for the dense generator, skipped" << endl;
+            continue;
+        }
+        for (const string& algo : {string("dijkstra"), string("prim")}) {
+            if (!opts.wants(opts.algorithms, algo)) continue;
+            bool directed = algo == "dijkstra";
+            Graph g = generateRandom(n, directed, static_cast<int>(target));
+            int edges = countEdges(g, directed);
+
+            vector<int> sources = pickSources(g.num_vertices(), opts);
+
+            for (const string& heap : heaps) {
+                if (algo == "prim" && heap == "radix") continue;
+                benchCell(out, opts, counters.get(), algo, heap, "dense", g, edges, sources);
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//random source/target pairs, full dijkstra sweep vs bidirectional search
+//a run is the whole batch of pairs, the two searches take turns going first
+//settled is the mean number of vertices taken out of the heaps per query,
+//matches says whether every bidirectional distance of every run agreed with
+//the sweep. --gen picks from sparse and grid
+void pointToPointSuite(const BenchOptions& opts) {
+    const int queries = 100;
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {10000, 100000})) {
+        int gridSide = static_cast<int>(sqrt(n));
+        vector<pair<string, CSRGraph>> graphs;
+        if (opts.wants(opts.generators, "sparse")) graphs.push_back({"sparse", CSRGraph(generateRandom(n, true, 3 * n))});
+        //directed grids only point right and down, most pairs have no path
+        if (opts.wants(opts.generators, "grid")) {
+            graphs.push_back({"grid", CSRGraph(generateGrid(gridSide, gridSide, false))});
+        }
+
+        for (const auto& [type, g] : graphs) {
+            //an undirected graph is its own reverse, this just keeps one type
+            CSRGraph rev = g.directed() ? reverseGraph(g) : g;
+            vector<pair<int, int>> pairs = pickPairs(g.num_vertices(), queries, opts);
+
+            for (const string& heap : heapsOr(opts, {"pairing", "dary4", "hollow"})) {
+                withHeap(heap, [&](auto& pq) {
+                    using PQ = typename std::decay<decltype(pq)>::type;
+                    PQ other;
+                    DijkstraResult full;
+                    DijkstraWorkspace<PQ> fullWs;
+                    PathResult path;
+                    BidirectionalWorkspace<PQ> ws;
+                    vector<long long> expected(queries);
+                    long long fullSettled = 0, bidirSettled = 0;
+                    int found = 0;
+                    bool matches = true;
+
+                    //untimed reference distances, the settled counts are the same every run
+                    for (int i = 0; i < queries; i++) {
+                        pq.reset();
+                        dijkstra_into(g, pairs[i].first, pq, full, fullWs);
+                        expected[i] = full.dist[pairs[i].second];
+                        fullSettled += pq.extractCount;
+                    }
+
+                    auto fullRun = [&](int) {
+                        return timeMs([&] {
+                            for (int i = 0; i < queries; i++) {
+                                pq.reset();
+                                dijkstra_into(g, pairs[i].first, pq, full, fullWs);
+                            }
+                        });
+                    };
+                    auto bidirRun = [&](int) {
+                        bidirSettled = 0;
+                        found = 0;
+                        return timeMs([&] {
+                            for (int i = 0; i < queries; i++) {
+                                bidirectional_dijkstra_into(g, rev, pairs[i].first, pairs[i].second, pq, other, path, ws);
+                                bidirSettled += path.settled;
+                                if (path.found) found++;
+                                if (path.found ? path.dist != expected[i] : expected[i] < SearchSpace<PQ>::INF) {
+                                    matches = false;
+                                }
+                            }
+                        });
+                    };
+                    auto [fullSt, bidirSt] = repeatPair(opts, fullRun, bidirRun);
+
+                    BenchRecord rec;
+                    rec.add("heap", heap).add("graph_type", type).add("n", g.num_vertices())
+                       .add("queries", queries).add("found", found)
+                       .add("warmup", opts.warmup).add("reps", opts.reps);
+                    addTiming(rec, "dijkstra_", fullSt);
+                    addTiming(rec, "bidir_", bidirSt);
+                    rec.add("speedup", fullSt.median / bidirSt.median)
+                       .add("dijkstra_settled", fullSettled / queries).add("bidir_settled", bidirSettled / queries)
+                       .add("settled_ratio", static_cast<double>(bidirSettled) / fullSettled)
+                       .add("matches", matches ? "yes" : "no");
+                    out.write(rec);
+                });
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//grid point to point: full dijkstra sweep, dijkstra stopping at the target
+//(astar with a zero heuristic) and astar with the manhattan heuristic
+//the heuristic is scaled by the smallest weight, so it helps most when the
+//weights are close together, hence the different max weights
+//a run is the whole batch of pairs, the three searches take turns going
+//first. matches covers every run, --gen is ignored since it is grids only
+void astarSuite(const BenchOptions& opts) {
+    const int queries = 100;
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {10000, 250000})) {
+        int side = static_cast<int>(sqrt(n));
+        for (int maxWeight : {1, 10, 1000}) {
+            CSRGraph g(generateGrid(side, side, false, maxWeight));
+            const long long minWeight = minEdgeWeight(g);
+            vector<pair<int, int>> pairs = pickPairs(g.num_vertices(), queries, opts);
+
+            for (const string& heap : heapsOr(opts, {"pairing", "dary4", "radix"})) {
+                withHeap(heap, [&](auto& pq) {
+                    using PQ = typename std::decay<decltype(pq)>::type;
+                    DijkstraResult full;
+                    DijkstraWorkspace<PQ> fullWs;
+                    PathResult path;
+                    SearchSpace<PQ> ws;
+                    vector<long long> expected(queries);
+                    long long fullSettled = 0, earlySettled = 0, astarSettled = 0;
+                    bool matches = true;
+
+                    //untimed reference distances, the settled counts are the same every run
+                    for (int i = 0; i < queries; i++) {
+                        pq.reset();
+                        dijkstra_into(g, pairs[i].first, pq, full, fullWs);
+                        expected[i] = full.dist[pairs[i].second];
+                        fullSettled += pq.extractCount;
+                    }
+
+                    auto fullRun = [&](int) {
+                        return timeMs([&] {
+                            for (int i = 0; i < queries; i++) {
+                                pq.reset();
+                                dijkstra_into(g, pairs[i].first, pq, full, fullWs);
+                            }
+                        });
+                    };
+                    auto earlyRun = [&](int) {
+                        earlySettled = 0;
+                        return timeMs([&] {
+                            for (int i = 0; i < queries; i++) {
+                                astar_into(g, pairs[i].first, pairs[i].second, pq, ZeroHeuristic(), path, ws);
+                                earlySettled += path.settled;
+                                if (path.dist != expected[i]) matches = false;
+                            }
+                        });
+                    };
+                    auto astarRun = [&](int) {
+                        astarSettled = 0;
+                        return timeMs([&] {
+                            for (int i = 0; i < queries; i++) {
+                                ManhattanHeuristic h(side, pairs[i].second, minWeight);
+                                astar_into(g, pairs[i].first, pairs[i].second, pq, h, path, ws);
+                                astarSettled += path.settled;
+                                if (path.dist != expected[i]) matches = false;
+                            }
+                        });
+                    };
+                    vector<SampleStats> st = repeatRotated(opts, {fullRun, earlyRun, astarRun});
+
+                    BenchRecord rec;
+                    rec.add("heap", heap).add("graph_type", "grid").add("n", g.num_vertices())
+                       .add("max_weight", maxWeight).add("queries", queries)
+                       .add("warmup", opts.warmup).add("reps", opts.reps);
+                    addTiming(rec, "dijkstra_", st[0]);
+                    addTiming(rec, "early_", st[1]);
+                    addTiming(rec, "astar_", st[2]);
+                    rec.add("speedup", st[0].median / st[2].median).add("speedup_vs_early", st[1].median / st[2].median)
+                       .add("dijkstra_settled", fullSettled / queries).add("early_settled", earlySettled / queries)
+                       .add("astar_settled", astarSettled / queries).add("matches", matches ? "yes" : "no");
+                    out.write(rec);
+                });
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//contraction hierarchy preprocessing and queries against a full dijkstra per
+//query, the hierarchy goes through a save and load at path on the way
+//random graphs have no hierarchy to find and their core ends up dense, so
+//they stay small here and show where ch stops paying off
+//build, save and load are each repeated, a query run is the whole batch of
+//pairs with the two searches taking turns going first, the _us columns are
+//per query from the medians. --size replaces the cases with a grid and a
+//sparse graph at each size, --gen picks from those two
+void chSuite(const string& path, const BenchOptions& opts) {
+    const int queries = 200;
+
+    struct Case {
+        string type;
+        int n;
+    };
+    vector<Case> cases = {{"grid", 10000}, {"grid", 40000}, {"sparse", 1000}, {"sparse", 2000}};
+    if (!opts.sizes.empty()) {
+        cases.clear();
+        for (int n : opts.sizes) {
+            cases.push_back({"grid", n});
+            cases.push_back({"sparse", n});
+        }
+    }
+
+    BenchWriter out(cout, opts.format);
+
+    for (const Case& c : cases) {
+        if (!opts.wants(opts.generators, c.type)) continue;
+        int side = static_cast<int>(sqrt(c.n));
+        Graph g = c.type == "grid" ? generateGrid(side, side, false) : generateRandom(c.n, true, 3 * c.n);
+        vector<pair<int, int>> pairs = pickPairs(g.num_vertices(), queries, opts);
+
+        for (const string& heap : heapsOr(opts, {"pairing"})) {
+            //the order queue's keys go down as well as up
+            if (heap == "radix") continue;
+            withHeapType(heap, [&](auto tag) {
+                using PQ = typename decltype(tag)::type;
+                ContractionHierarchy built;
+                SampleStats buildSt = repeatRuns(opts, [&](int) {
+                    return timeMs([&] { built = ContractionHierarchy::build<PQ>(g); });
+                });
+                SampleStats saveSt = repeatRuns(opts, [&](int) { return timeMs([&] { built.save(path); }); });
+                ContractionHierarchy ch;
+                SampleStats loadSt = repeatRuns(opts, [&](int) {
+                    return timeMs([&] { ch = ContractionHierarchy::load(path); });
+                });
+                remove(path.c_str());
+
+                PQ pq, other;
+                DijkstraResult full;
+                DijkstraWorkspace<PQ> fullWs;
+                PathResult res;
+                BidirectionalWorkspace<PQ> ws;
+                vector<long long> expected(queries);
+                long long fullSettled = 0, chSettled = 0;
+                bool matches = true;
+
+                //untimed reference distances, the settled counts are the same every run
+                for (int i = 0; i < queries; i++) {
+                    pq.reset();
+                    dijkstra_into(g, pairs[i].first, pq, full, fullWs);
+                    expected[i] = full.dist[pairs[i].second];
+                    fullSettled += pq.extractCount;
+                }
+
+                auto fullRun = [&](int) {
+                    return timeMs([&] {
+                        for (int i = 0; i < queries; i++) {
+                            pq.reset();
+                            dijkstra_into(g, pairs[i].first, pq, full, fullWs);
+                        }
+                    });
+                };
+                auto chRun = [&](int) {
+                    chSettled = 0;
+                    return timeMs([&] {
+                        for (int i = 0; i < queries; i++) {
+                            ch.query_into(pairs[i].first, pairs[i].second, pq, other, res, ws);
+                            chSettled += res.settled;
+                            if (res.found ? res.dist != expected[i] : expected[i] < SearchSpace<PQ>::INF) {
+                                matches = false;
+                            }
+                        }
+                    });
+                };
+                auto [fullSt, chSt] = repeatPair(opts, fullRun, chRun);
+
+                BenchRecord rec;
+                rec.add("heap", heap).add("graph_type", c.type).add("n", g.num_vertices())
+                   .add("edges", countEdges(g, g.directed())).add("shortcuts", ch.num_shortcuts())
+                   .add("arcs", ch.num_arcs()).add("queries", queries)
+                   .add("warmup", opts.warmup).add("reps", opts.reps);
+                addTiming(rec, "preprocess_", buildSt);
+                addTiming(rec, "save_", saveSt);
+                addTiming(rec, "load_", loadSt);
+                addTiming(rec, "dijkstra_", fullSt);
+                addTiming(rec, "ch_", chSt);
+                rec.add("dijkstra_us", fullSt.median * 1000 / queries).add("ch_us", chSt.median * 1000 / queries)
+                   .add("speedup", fullSt.median / chSt.median)
+                   .add("dijkstra_settled", fullSettled / queries).add("ch_settled", chSettled / queries)
+                   .add("matches", matches ? "yes" : "no");
+                out.write(rec);
+            });
+        }
+    }
+
+    out.finish();
+}
+
+//one alt configuration on a set of pairs, against the dijkstra baseline
+//(astar with no heuristic) already measured for the same pairs
+//the table build is repeated like the query runs, the last build is queried
+template<typename T, typename PQ, typename GraphT>
+void altRow(BenchWriter& out, const BenchOptions& opts, const string& heap, const string& type, const GraphT& g,
+            LandmarkSelection selection, int threads, const vector<pair<int, int>>& pairs,
+            const vector<long long>& expected, const SampleStats& base, long long baseSettled) {
+    AltOptions alt;
+    alt.selection = selection;
+    alt.threads = threads;
+    LandmarkTable<T> table;
+    SampleStats build = repeatRuns(opts, [&](int) {
+        return timeMs([&] { table = LandmarkTable<T>::template build<PQ>(g, alt); });
+    });
 
-            r = runDijkstra(sparseDi, 0, heap);
-            cout << "dijkstra," << heap << ",sparse," << n << "," << countEdges(sparseDi, true) << "," << r.time_ms << "," << r.inserts << "," << r.extracts << "," << r.decreaseKeys << endl;
+    PQ pq;
+    SearchSpace<PQ> ws;
+    PathResult res;
+    long long settled = 0;
+    bool matches = true;
+    SampleStats st = repeatRuns(opts, [&](int) {
+        settled = 0;
+        return timeMs([&] {
+            for (size_t i = 0; i < pairs.size(); i++) {
+                AltHeuristic<T> h(table, pairs[i].first, pairs[i].second);
+                astar_into(g, pairs[i].first, pairs[i].second, pq, h, res, ws);
+                settled += res.settled;
+                if (res.found ? res.dist != expected[i] : expected[i] < SearchSpace<PQ>::INF) matches = false;
+            }
+        });
+    });
 
-            r = runDijkstra(denseDi, 0, heap);
-            cout << "dijkstra," << heap << ",dense," << n << "," << countEdges(denseDi, true) << "," << r.time_ms << "," << r.inserts << "," << r.extracts << "," << r.decreaseKeys << endl;
+    const long long queries = static_cast<long long>(pairs.size());
+    BenchRecord rec;
+    rec.add("heap", heap).add("graph_type", type).add("n", g.num_vertices())
+       .add("selection", selection == LANDMARKS_FARTHEST ? "farthest" : "avoid")
+       .add("landmarks", table.num_landmarks()).add("bits", static_cast<int>(sizeof(T) * 8)).add("threads", threads)
+       .add("table_mb", table.bytes() / 1048576.0).add("queries", queries)
+       .add("warmup", opts.warmup).add("reps", opts.reps);
+    addTiming(rec, "preprocess_", build);
+    addTiming(rec, "alt_", st);
+    rec.add("dijkstra_median_ms", base.median)
+       .add("dijkstra_us", base.median * 1000 / queries).add("alt_us", st.median * 1000 / queries)
+       .add("speedup", base.median / st.median)
+       .add("dijkstra_settled", baseSettled / queries).add("alt_settled", settled / queries)
+       .add("settled_ratio", static_cast<double>(baseSettled) / settled).add("matches", matches ? "yes" : "no");
+    out.write(rec);
+}
+
+//alt with 16 landmarks, both selections and both table widths, against
+//dijkstra stopping at the target on the same random pairs
+//a run is the whole batch of pairs, the baseline is measured once per graph
+//and heap. --gen picks from grid and sparse, radix is skipped since alt's
+//bound is only consistent when no table had to scale its distances
+void altSuite(int threads, const BenchOptions& opts) {
+    const int queries = 200;
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {250000})) {
+        for (const string& type : {string("grid"), string("sparse")}) {
+            if (!opts.wants(opts.generators, type)) continue;
+            int side = static_cast<int>(sqrt(n));
+            CSRGraph g(type == "grid" ? generateGrid(side, side, false) : generateRandom(n, true, 3 * n));
+            vector<pair<int, int>> pairs = pickPairs(g.num_vertices(), queries, opts);
 
-            int gridN = gridSide * gridSide;
-            r = runDijkstra(gridDi, 0, heap);
-            cout << "dijkstra," << heap << ",grid," << gridN << "," << countEdges(gridDi, true) << "," << r.time_ms << "," << r.inserts << "," << r.extracts << "," << r.decreaseKeys << endl;
+            for (const string& heap : heapsOr(opts, {"pairing"})) {
+                if (heap == "radix") continue;
+                withHeapType(heap, [&](auto tag) {
+                    using PQ = typename decltype(tag)::type;
+                    PQ pq;
+                    SearchSpace<PQ> ws;
+                    PathResult res;
+                    vector<long long> expected(queries);
+                    long long baseSettled = 0;
+                    SampleStats base = repeatRuns(opts, [&](int) {
+                        baseSettled = 0;
+                        return timeMs([&] {
+                            for (int i = 0; i < queries; i++) {
+                                astar_into(g, pairs[i].first, pairs[i].second, pq, ZeroHeuristic(), res, ws);
+                                expected[i] = res.found ? res.dist : SearchSpace<PQ>::INF;
+                                baseSettled += res.settled;
+                            }
+                        });
+                    });
+
+                    for (LandmarkSelection selection : {LANDMARKS_FARTHEST, LANDMARKS_AVOID}) {
+                        altRow<uint16_t, PQ>(out, opts, heap, type, g, selection, threads, pairs, expected, base, baseSettled);
+                        altRow<uint32_t, PQ>(out, opts, heap, type, g, selection, threads, pairs, expected, base, baseSettled);
+                    }
+                });
+            }
         }
+    }
+
+    out.finish();
+}
+
+//a stream of random edge inserts and weight decreases applied in batches,
+//repaired incrementally vs dijkstra rerun from scratch after every batch
+//a run replays the whole stream, drawn from opts.seed, on a fresh copy of
+//the graph, and its repair and rerun times are the sums over its batches
+//matches compares the repaired distances with a fresh run at the end of
+//every run. --gen is ignored, the graph is always sparse
+void dynamicSuite(const BenchOptions& opts) {
+    const int batches = 50;
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {100000})) {
+        const Graph base = generateRandom(n, true, 3 * n);
 
-        //prim tests
-        for (const string& heap : heaps) {
-            BenchResult r;
+        for (const string& heap : heapsOr(opts, {"pairing"})) {
+            withHeapType(heap, [&](auto tag) {
+                using PQ = typename decltype(tag)::type;
 
-            r = runPrim(sparseUn, 0, heap);
-            cout << "prim," << heap << ",sparse," << n << "," << countEdges(sparseUn, false) << "," << r.time_ms << "," << r.inserts << "," << r.extracts << "," << r.decreaseKeys << endl;
+                for (int batch : {1, 10, 100, 1000}) {
+                    vector<double> repairSamples, rerunSamples;
+                    long long settled = 0;
+                    bool matches = true;
 
-            r = runPrim(denseUn, 0, heap);
-            cout << "prim," << heap << ",dense," << n << "," << countEdges(denseUn, false) << "," << r.time_ms << "," << r.inserts << "," << r.extracts << "," << r.decreaseKeys << endl;
+                    for (int run = 0; run < opts.warmup + opts.reps; run++) {
+                        Graph g = base;
+                        DynamicSSSP<PQ> dyn(g, 0);
+                        mt19937_64 rng(opts.seed);
+                        uniform_int_distribution<int> pick(0, n - 1);
+                        uniform_int_distribution<int> weight(1, 1000);
 
-            int gridN = gridSide * gridSide;
-            r = runPrim(gridUn, 0, heap);
-            cout << "prim," << heap << ",grid," << gridN << "," << countEdges(gridUn, false) << "," << r.time_ms << "," << r.inserts << "," << r.extracts << "," << r.decreaseKeys << endl;
+                        PQ pq;
+                        DijkstraResult fresh;
+                        DijkstraWorkspace<PQ> ws;
+                        double repairMs = 0, rerunMs = 0;
+                        vector<EdgeUpdate> updates;
+                        settled = 0;
+
+                        for (int b = 0; b < batches; b++) {
+                            updates.clear();
+                            for (int i = 0; i < batch; i++) {
+                                int u = pick(rng);
+                                const auto& nbrs = g.neighbors(u);
+                                if (i % 2 == 0 || nbrs.empty()) {
+                                    updates.push_back({EdgeUpdate::INSERT, u, pick(rng), weight(rng)});
+                                } else {
+                                    const Graph::Edge& e = nbrs[rng() % nbrs.size()];
+                                    updates.push_back({EdgeUpdate::DECREASE, u, e.to, e.weight / 2});
+                                }
+                            }
+                            repairMs += timeMs([&] { dyn.apply(updates); });
+                            settled += dyn.settled();
+                            rerunMs += timeMs([&] {
+                                pq.reset();
+                                dijkstra_into(g, 0, pq, fresh, ws);
+                            });
+                        }
+
+                        matches = matches && fresh.dist == dyn.result().dist;
+                        if (run < opts.warmup) continue;
+                        repairSamples.push_back(repairMs);
+                        rerunSamples.push_back(rerunMs);
+                    }
+
+                    SampleStats repair = summarize(repairSamples);
+                    SampleStats rerun = summarize(rerunSamples);
+                    BenchRecord rec;
+                    rec.add("heap", heap).add("graph_type", "sparse").add("n", n).add("batch", batch)
+                       .add("batches", batches).add("warmup", opts.warmup).add("reps", opts.reps);
+                    addTiming(rec, "repair_", repair);
+                    addTiming(rec, "rerun_", rerun);
+                    rec.add("speedup", rerun.median / repair.median).add("settled_per_batch", settled / batches)
+                       .add("matches", matches ? "yes" : "no");
+                    out.write(rec);
+                }
+            });
         }
     }
 
+    out.finish();
+}
+
+//random edge inserts in batches, folded into the forest by DynamicMST vs
+//prim_mst rerun from scratch after every batch. batches above n / 8 take
+//the kruskal rebuild instead of one link cut update per edge
+//a run replays the whole stream, drawn from opts.seed, on a fresh copy of
+//the graph, and its insert and rerun times are the sums over its batches
+//matches compares the total weight with a fresh prim run at the end of
+//every run. --heap is prim's heap, --gen is ignored, the graph is sparse
+void dynamicMstSuite(const BenchOptions& opts) {
+    const int batches = 20;
+    BenchWriter out(cout, opts.format);
+
+    for (int n : sizesOr(opts, {100000})) {
+        const Graph base = generateRandom(n, false, 3 * n);
+
+        for (const string& heap : heapsOr(opts, {"pairing"})) {
+            //radix is monotone, prim's keys are not
+            if (heap == "radix") continue;
+            withHeapType(heap, [&](auto tag) {
+                using PQ = typename decltype(tag)::type;
+
+                for (int batch : {1, 10, 100, 1000, 10000, 25000}) {
+                    vector<double> insertSamples, rerunSamples;
+                    bool matches = true;
+
+                    for (int run = 0; run < opts.warmup + opts.reps; run++) {
+                        Graph g = base;
+                        DynamicMST dyn(g);
+                        mt19937_64 rng(opts.seed);
+                        uniform_int_distribution<int> pick(0, n - 1);
+                        uniform_int_distribution<int> weight(1, 1000);
+
+                        PQ pq;
+                        PrimResult fresh;
+                        double insertMs = 0, rerunMs = 0;
+                        vector<MstEdge> edges;
+
+                        for (int b = 0; b < batches; b++) {
+                            edges.clear();
+                            for (int i = 0; i < batch; i++) edges.push_back({pick(rng), pick(rng), weight(rng)});
+                            insertMs += timeMs([&] { dyn.apply(edges); });
+                            rerunMs += timeMs([&] {
+                                pq.reset();
+                                fresh = prim_mst(g, 0, pq);
+                            });
+                        }
+
+                        matches = matches && fresh.connected == dyn.connected() &&
+                                  (!fresh.connected || fresh.total_weight == dyn.total_weight());
+                        if (run < opts.warmup) continue;
+                        insertSamples.push_back(insertMs);
+                        rerunSamples.push_back(rerunMs);
+                    }
+
+                    SampleStats insert = summarize(insertSamples);
+                    SampleStats rerun = summarize(rerunSamples);
+                    BenchRecord rec;
+                    rec.add("heap", heap).add("graph_type", "sparse").add("n", n).add("batch", batch)
+                       .add("batches", batches).add("warmup", opts.warmup).add("reps", opts.reps);
+                    addTiming(rec, "insert_", insert);
+                    addTiming(rec, "rerun_", rerun);
+                    rec.add("speedup", rerun.median / insert.median).add("matches", matches ? "yes" : "no");
+                    out.write(rec);
+                }
+            });
+        }
+    }
+
+    out.finish();
+}
+
+//one ordering of one graph: dijkstra and prim from the same original
+//vertices on the csr layout, sources already in this graph's ids
+//counters are medians over the timed runs, speedups are over base, the
+//dijkstra and prim medians of the original row. returns this row's
+//medians, the original row passes {0, 0}
+pair<double, double> reorderRow(BenchWriter& out, const BenchOptions& opts, const string& heap,
+                                const string& graphType, const string& orderName, const CSRGraph& g,
+                                const vector<int>& sources, const SampleStats& reorder, PerfCounters& counters,
+                                pair<double, double> base) {
+    vector<PerfSample> dijPerf, primPerf;
+    SampleStats dij = repeatRuns(opts, [&](int i) {
+        BenchResult r = runDijkstra(g, sources[i], heap, &counters);
+        if (i >= opts.warmup) dijPerf.push_back(r.perf);
+        return r.time_ms;
+    });
+    SampleStats prim = repeatRuns(opts, [&](int i) {
+        BenchResult r = runPrim(g, sources[i], heap, &counters);
+        if (i >= opts.warmup) primPerf.push_back(r.perf);
+        return r.time_ms;
+    });
+    if (base.first <= 0) base = {dij.median, prim.median};
+
+    BenchRecord rec;
+    rec.add("heap", heap).add("graph_type", graphType).add("n", g.num_vertices()).add("order", orderName)
+       .add("warmup", opts.warmup).add("reps", opts.reps);
+    addTiming(rec, "reorder_", reorder);
+    addTiming(rec, "dijkstra_", dij);
+    addPerfColumns(rec, dijPerf, "dijkstra_");
+    addTiming(rec, "prim_", prim);
+    addPerfColumns(rec, primPerf, "prim_");
+    rec.add("dijkstra_speedup", base.first / dij.median).add("prim_speedup", base.second / prim.median);
+    out.write(rec);
+    return {dij.median, prim.median};
+}
+
+//vertex reordering: dijkstra and prim on the graph as generated vs
+//relabeled by each order, speedups are over the original ids
+//sparse ids come shuffled from generateRandom, grid ids are row major
+//already, and grid_shuffled is the same grid with random ids, like ids from
+//outside would be. hilbert needs the grid coordinates so only runs on grid
+//reorder_ columns time building the relabeled csr graph (zero for the
+//original row), counters are NA without a pmu. --gen picks from sparse, grid
+//and grid_shuffled, --heap defaults to pairing and skips radix since every
+//row runs prim too
+void reorderSuite(const BenchOptions& opts) {
+    PerfCounters counters;
+    if (!counters.available()) cerr << "hardware counters unavailable, their columns will be NA" << endl;
+    BenchWriter out(cout, opts.format);
+
+    vector<pair<string, VertexOrder>> orders = {
+        {"bfs", ORDER_BFS}, {"rcm", ORDER_RCM}, {"degree", ORDER_DEGREE}, {"hilbert", ORDER_HILBERT}};
+
+    for (int size : sizesOr(opts, {1000000})) {
+        const int side = static_cast<int>(sqrt(size));
+        const int n = side * side;
+        Graph grid = generateGrid(side, side, false);
+        vector<int> shuffled(n);
+        for (int i = 0; i < n; i++) shuffled[i] = i;
+        mt19937_64 rng(opts.seed);
+        shuffle(shuffled.begin(), shuffled.end(), rng);
+
+        vector<pair<string, CSRGraph>> graphs;
+        if (opts.wants(opts.generators, "sparse")) graphs.push_back({"sparse", CSRGraph(generateRandom(n, false, 3 * n))});
+        if (opts.wants(opts.generators, "grid")) graphs.push_back({"grid", CSRGraph(grid)});
+        if (opts.wants(opts.generators, "grid_shuffled")) {
+            graphs.push_back({"grid_shuffled", ReorderedGraph(grid, shuffled).graph()});
+        }
+
+        for (const auto& [type, g] : graphs) {
+            vector<int> sources = pickSources(n, opts);
+
+            for (const string& heap : heapsOr(opts, {"pairing"})) {
+                if (heap == "radix") continue;
+                pair<double, double> base =
+                    reorderRow(out, opts, heap, type, "original", g, sources, SampleStats(), counters, {0, 0});
+
+                for (const auto& [orderName, order] : orders) {
+                    if (order == ORDER_HILBERT && type != "grid") continue;
+                    optional<ReorderedGraph> reordered;
+                    SampleStats reorder = repeatRuns(opts, [&](int) {
+                        reordered.reset();
+                        return timeMs([&] { reordered.emplace(g, order, side); });
+                    });
+                    vector<int> mapped(sources.size());
+                    for (size_t i = 0; i < sources.size(); i++) mapped[i] = reordered->to_new(sources[i]);
+                    reorderRow(out, opts, heap, type, orderName, reordered->graph(), mapped, reorder, counters, base);
+                }
+            }
+        }
+    }
+
+    out.finish();
+}
+
+//pick a suite with the first argument, default is the full heap matrix
+//every suite takes the BenchOptions flags: each measurement gets opts.warmup
+//untimed runs and opts.reps timed ones, rows carry median/p95/mean/stddev/
+//min/max (phases, which only counts, carries counter medians) and --format
+//json writes a json array. --algo, --heap, --gen and --size filter or replace
+//the suite's own lists.
+//suites with a second argument take it before the flags, e.g.
+//evaluate scaling 8 --size 200000 --reps 5
+//  matrix  every heap on every generator and size, e.g.
+//          evaluate matrix --algo dijkstra --heap pairing,dary4 --size 10000 --reps 20 --format json
+//          a bare evaluate --heap pairing also runs the matrix, --perf 1 adds
+//          hardware counter columns. built with -DPQ_INSTRUMENT it also has
+//          per operation latency percentiles and each heap's structure metric
+//  phases  hardware counters split by heap operation for each heap
+//  decrease_key  decrease_key heavy dense graphs
+//  layout  adjacency list vs csr speedup
+//  pooling back to back queries with pooled vs unpooled heap nodes
+//  dispatch virtual PriorityQueue calls vs concrete heap type
+//  integer  radix heap and dial buckets vs comparison heaps
+//  scaling  delta stepping thread scaling, second argument is the max thread count
+//  mst_scaling  boruvka thread scaling, same second argument
+//  throughput  batch query throughput per heap and thread count, same second argument
+//  io  binary graph file write and mmap open, second argument is the scratch file path
+//  p2p  full dijkstra vs bidirectional search on random source/target pairs
+//  astar  dijkstra vs astar with the manhattan heuristic on grid pairs
+//  ch  contraction hierarchy preprocessing and query latency, second argument is the scratch file path
+//  alt  landmark preprocessing and alt queries vs dijkstra, second argument is the thread count for the tables
+//  dynamic  incremental sssp repair vs rerunning dijkstra after each update batch
+//  dynamic_mst  incremental minimum spanning forest vs rerunning prim after each insert batch
+//  reorder  dijkstra and prim time and cache misses before and after each vertex reordering
+//  generators  old generators vs parallel csr generators, second argument is the max thread count
+//scaling, mst_scaling, throughput, io, generators, p2p, astar, ch, alt,
+//dynamic, dynamic_mst and reorder default to 3 reps and 1 warmup
+int main(int argc, char* argv[]) {
+    bool flagsOnly = argc > 1 && string(argv[1]).rfind("--", 0) == 0;
+    string suite = argc > 1 && !flagsOnly ? argv[1] : "matrix";
+
+    //these take a thread count or a scratch file path before the flags
+    const vector<string> withArgument = {"scaling", "mst_scaling", "throughput", "io", "ch", "alt", "generators"};
+    bool hasArgument = find(withArgument.begin(), withArgument.end(), suite) != withArgument.end() &&
+                       argc > 2 && string(argv[2]).rfind("--", 0) != 0;
+    string argument = hasArgument ? argv[2] : "";
+
+    //one run of these takes seconds, so they repeat less unless --reps says otherwise
+    BenchOptions defaults;
+    const vector<string> slow = {"scaling", "mst_scaling", "throughput", "io", "generators", "p2p",
+                                 "astar", "ch", "alt", "dynamic", "dynamic_mst", "reorder"};
+    if (find(slow.begin(), slow.end(), suite) != slow.end()) {
+        defaults.reps = 3;
+        defaults.warmup = 1;
+    }
+
+    BenchOptions opts;
+    try {
+        opts = parseBenchOptions(argc, argv, flagsOnly ? 1 : (hasArgument ? 3 : 2), defaults);
+    } catch (const invalid_argument& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    auto maxThreads = [&] {
+        int threads = hasArgument ? stoi(argument) : static_cast<int>(thread::hardware_concurrency());
+        return threads < 1 ? 1 : threads;
+    };
+
+    if (suite == "matrix") {
+        matrixSuite(opts);
+    } else if (suite == "decrease_key") {
+        decreaseKeySuite(opts);
+    } else if (suite == "phases") {
+        phasesSuite(opts);
+    } else if (suite == "layout") {
+        layoutSuite(opts);
+    } else if (suite == "pooling") {
+        poolingSuite(opts);
+    } else if (suite == "dispatch") {
+        dispatchSuite(opts);
+    } else if (suite == "integer") {
+        integerSuite(opts);
+    } else if (suite == "scaling") {
+        scalingSuite(maxThreads(), opts);
+    } else if (suite == "mst_scaling") {
+        mstScalingSuite(maxThreads(), opts);
+    } else if (suite == "throughput") {
+        throughputSuite(maxThreads(), opts);
+    } else if (suite == "io") {
+        ioSuite(hasArgument ? argument : "evaluate_graph.bin", opts);
+    } else if (suite == "p2p") {
+        pointToPointSuite(opts);
+    } else if (suite == "astar") {
+        astarSuite(opts);
+    } else if (suite == "ch") {
+        chSuite(hasArgument ? argument : "evaluate_ch.bin", opts);
+    } else if (suite == "alt") {
+        altSuite(maxThreads(), opts);
+    } else if (suite == "dynamic") {
+        dynamicSuite(opts);
+    } else if (suite == "dynamic_mst") {
+        dynamicMstSuite(opts);
+    } else if (suite == "reorder") {
+        reorderSuite(opts);
+    } else if (suite == "generators") {
+        generatorSuite(maxThreads(), opts);
+    } else {
+        cerr << "unknown suite: " << suite << endl;
+        return 1;
+    }
+
     return 0;
-}
\ No newline at end of file
+}
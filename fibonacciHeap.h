@@ -4,6 +4,7 @@
 #define FIBONACCI_HEAP_H
 
 #include "priorityQueue.h"
+#include "nodePool.h"
 #include <stdexcept>
 #include <vector>
 #include <cmath>
@@ -29,11 +30,18 @@ struct FibNode : public Node<K,V> {
     }
 };
 
+//structure stat (PQ_INSTRUMENT builds): root list length at each consolidate
 template<typename K, typename V>
-class FibonacciHeap : public PriorityQueue<K,V> {
+class FibonacciHeap final : public PriorityQueue<K,V> {
 private:
     FibNode<K,V>* minNode;
     int nodeCount;
+    NodePool<FibNode<K,V>> pool_;
+
+    //scratch for consolidate, kept so extract_min stops allocating once
+    //they have grown to the largest root list seen
+    vector<FibNode<K,V>*> degreeTable_;
+    vector<FibNode<K,V>*> roots_;
 
     void insertIntoList(FibNode<K,V>* listNode, FibNode<K,V>* node) {
         node->left = listNode;
@@ -68,9 +76,11 @@ private:
     //merge trees of same degree after extract_min
     void consolidate() {
         int maxDegree = static_cast<int>(log2(nodeCount)) + 2; //formula for maximum possible degree of tree
-        vector<FibNode<K,V>*> A(maxDegree, nullptr);
+        vector<FibNode<K,V>*>& A = degreeTable_;
+        A.assign(maxDegree, nullptr);
 
-        vector<FibNode<K,V>*> roots;
+        vector<FibNode<K,V>*>& roots = roots_;
+        roots.clear();
         FibNode<K,V>* curr = minNode;
         if (curr != nullptr) {
             do {
@@ -78,6 +88,7 @@ private:
                 curr = curr->right;
             } while (curr != minNode);
         }
+        this->recordStructure(static_cast<long long>(roots.size()));
 
         for (FibNode<K,V>* w : roots) {
             FibNode<K,V>* x = w;
@@ -141,47 +152,72 @@ private:
     }
 
     //cuts marked nodes
-    //node is cut if it loses first child
+    //node is cut if it loses first child, walks up until an unmarked node
     void cascadingCut(FibNode<K,V>* y) {
         FibNode<K,V>* z = y->parent;
-        if (z != nullptr) {
+        while (z != nullptr) {
             if (!y->marked) {
                 y->marked = true;
-            } else {
-                cut(y, z);
-                cascadingCut(z);
+                return;
             }
+            cut(y, z);
+            y = z;
+            z = y->parent;
         }
     }
 
+    //frees every node reachable from the ring at start without recursion
+    //the ring is opened into a list and each node's children are spliced in
+    //right after it before it is released
     void deleteAll(FibNode<K,V>* start) {
         if (start == nullptr) return;
 
+        start->left->right = nullptr;
         FibNode<K,V>* curr = start;
-        do {
+        while (curr != nullptr) {
+            if (curr->child != nullptr) {
+                FibNode<K,V>* first = curr->child;
+                FibNode<K,V>* last = first->left;
+                last->right = curr->right;
+                curr->right = first;
+            }
             FibNode<K,V>* next = curr->right;
-            deleteAll(curr->child);
-            delete curr;
+            pool_.release(curr);
             curr = next;
-        } while (curr != start);
+        }
     }
 
 public:
-    FibonacciHeap() : minNode(nullptr), nodeCount(0) {}
+    //pooled = false allocates every node with new like before
+    explicit FibonacciHeap(bool pooled = true) : minNode(nullptr), nodeCount(0), pool_(pooled) {}
 
     ~FibonacciHeap() override {
-        if (minNode != nullptr) {
+        if (minNode != nullptr && !pool_.skipRelease()) {
             deleteAll(minNode);
         }
     }
 
+    void reset() override {
+        if (minNode != nullptr && !pool_.skipRelease()) {
+            deleteAll(minNode);
+        }
+        pool_.reset();
+        minNode = nullptr;
+        nodeCount = 0;
+        this->resetCounters();
+    }
+
+    //times the system allocator was called for nodes
+    long long allocations() const { return pool_.allocations(); }
+
     bool is_empty() override {
         return minNode == nullptr;
     }
 
     Node<K,V>* insert(K key, V value) override {
         this->insertCount++;
-        FibNode<K,V>* node = new FibNode<K,V>(key, value);
+        OpTimer timer(this->insertHistogram());
+        FibNode<K,V>* node = pool_.acquire(key, value);
 
         if (minNode == nullptr) {
             minNode = node;
@@ -205,6 +241,7 @@ public:
 
     pair<K,V> extract_min() override {
         this->extractCount++;
+        OpTimer timer(this->extractHistogram());
         if (minNode == nullptr) {
             throw runtime_error("Heap is empty");
         }
@@ -233,12 +270,13 @@ public:
         }
 
         nodeCount--;
-        delete z;
+        pool_.release(z);
         return result;
     }
 
     void decrease_key(Node<K,V>* node, K new_key) override {
         this->decreaseKeyCount++;
+        OpTimer timer(this->decreaseKeyHistogram());
         FibNode<K,V>* x = static_cast<FibNode<K,V>*>(node);
 
         if (new_key > x->key) {
@@ -35,6 +35,28 @@ public:
         }
     }
 
+    // Lower the weight of edge u -> v (and v -> u if undirected) to w
+    // With parallel edges the lightest one is lowered; returns false if it is already <= w
+    bool decrease_weight(int u, int v, int w) {
+        if (u < 0 || u >= n_ || v < 0 || v >= n_) {
+            throw std::out_of_range("Graph::decrease_weight: vertex out of range");
+        }
+        if (w < 0) {
+            throw std::invalid_argument("Graph::decrease_weight: negative weights not allowed for Dijkstra");
+        }
+
+        Edge* e = lightest(u, v);
+        if (e == nullptr) {
+            throw std::invalid_argument("Graph::decrease_weight: no such edge");
+        }
+        if (e->weight <= w) return false;
+        e->weight = w;
+        if (!directed_) {
+            lightest(v, u)->weight = w;
+        }
+        return true;
+    }
+
     const std::vector<Edge>& neighbors(int u) const {
         if (u < 0 || u >= n_) throw std::out_of_range("Graph::neighbors: vertex out of range");
         return adj_[u];
@@ -44,6 +66,14 @@ private:
     int n_;
     bool directed_;
     std::vector<std::vector<Edge>> adj_;
+
+    Edge* lightest(int u, int v) {
+        Edge* best = nullptr;
+        for (Edge& e : adj_[u]) {
+            if (e.to == v && (best == nullptr || e.weight < best->weight)) best = &e;
+        }
+        return best;
+    }
 };
 
 #endif
@@ -0,0 +1,221 @@
+#ifndef GRAPH_FILE_H
+#define GRAPH_FILE_H
+
+#include "graph.h"
+#include "csrGraph.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//binary graph file, version 1
+//  header   GraphFileHeader, 64 bytes
+//  offsets  (n + 1) int64, offsets[u] .. offsets[u+1] index u's edges
+//  edges    arcs Graph::Edge {int32 to, int32 weight}
+//both arrays start on a 64 byte boundary and use the machine's byte order,
+//so a mapped file is already a csr graph and needs no parsing
+const char GRAPH_FILE_MAGIC[8] = {'C', 'S', '4', '7', '0', 'G', 'R', 'F'};
+const uint32_t GRAPH_FILE_VERSION = 1;
+const uint32_t GRAPH_FILE_DIRECTED = 1;
+
+struct GraphFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    int64_t n;
+    int64_t arcs;
+    int64_t offsetsPos;  //byte position of the offsets array
+    int64_t edgesPos;    //byte position of the edge array
+    int64_t reserved[2];
+};
+
+static_assert(sizeof(GraphFileHeader) == 64, "GraphFileHeader must stay 64 bytes");
+static_assert(sizeof(Graph::Edge) == 8, "Graph::Edge layout is part of the file format");
+
+inline int64_t alignTo64(int64_t pos) {
+    return (pos + 63) & ~static_cast<int64_t>(63);
+}
+
+//write any graph with num_vertices(), directed() and neighbors(u)
+template<typename GraphT>
+inline void writeGraphFile(const std::string& path, const GraphT& g) {
+    const int n = g.num_vertices();
+
+    std::vector<int64_t> offsets(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        offsets[u + 1] = offsets[u] + static_cast<int64_t>(g.neighbors(u).size());
+    }
+
+    GraphFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_FILE_VERSION;
+    header.flags = g.directed() ? GRAPH_FILE_DIRECTED : 0;
+    header.n = n;
+    header.arcs = offsets[n];
+    header.offsetsPos = alignTo64(sizeof(header));
+    header.edgesPos = alignTo64(header.offsetsPos + static_cast<int64_t>(offsets.size() * sizeof(int64_t)));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("writeGraphFile: cannot open " + path);
+
+    const char zeros[64] = {};
+    auto padTo = [&](int64_t pos) {
+        int64_t at = static_cast<int64_t>(out.tellp());
+        out.write(zeros, pos - at);
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    padTo(header.offsetsPos);
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(int64_t));
+    padTo(header.edgesPos);
+    for (int u = 0; u < n; ++u) {
+        const auto& nbrs = g.neighbors(u);
+        if (nbrs.size() == 0) continue;
+        out.write(reinterpret_cast<const char*>(&*nbrs.begin()), nbrs.size() * sizeof(Graph::Edge));
+    }
+
+    if (!out) throw std::runtime_error("writeGraphFile: write failed for " + path);
+}
+
+//read only memory mapped graph file
+//opening maps the file and checks the header, nothing is read or copied,
+//pages come in on first touch, so open time does not depend on the size
+//the header checks keep both arrays inside the mapping, but the offsets and
+//arc targets themselves are trusted. verify() checks them in one pass over
+//the file, call it before querying a file that did not come from
+//writeGraphFile. same interface as CSRGraph so it goes straight into
+//dijkstra() and prim_mst()
+class MappedGraph {
+public:
+    explicit MappedGraph(const std::string& path) : base_(nullptr), size_(0) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("MappedGraph: cannot open " + path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedGraph: cannot stat " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ < sizeof(GraphFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("MappedGraph: file too small for a header: " + path);
+        }
+
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("MappedGraph: mmap failed for " + path);
+        base_ = static_cast<const char*>(p);
+
+        try {
+            validate(path);
+        } catch (...) {
+            ::munmap(const_cast<char*>(base_), size_);
+            throw;
+        }
+    }
+
+    MappedGraph(const MappedGraph&) = delete;
+    MappedGraph& operator=(const MappedGraph&) = delete;
+
+    MappedGraph(MappedGraph&& other) noexcept
+        : base_(other.base_), size_(other.size_), n_(other.n_), directed_(other.directed_),
+          offsets_(other.offsets_), edges_(other.edges_) {
+        other.base_ = nullptr;
+        other.size_ = 0;
+    }
+
+    ~MappedGraph() {
+        if (base_ != nullptr) ::munmap(const_cast<char*>(base_), size_);
+    }
+
+    int num_vertices() const { return n_; }
+    bool directed() const { return directed_; }
+
+    //number of stored arcs, undirected edges are counted twice
+    long long num_arcs() const { return offsets_[n_]; }
+
+    EdgeRange neighbors(int u) const {
+        if (u < 0 || u >= n_) throw std::out_of_range("MappedGraph::neighbors: vertex out of range");
+        return {edges_ + offsets_[u], edges_ + offsets_[u + 1]};
+    }
+
+    //one pass over both arrays so neighbors() and the algorithms can trust
+    //them: offsets never go down (so with both ends checked at open they
+    //stay in [0, arcs]), arcs point at real vertices and weigh >= 0
+    //O(n + arcs) and reads the whole file, throws runtime_error
+    void verify() const {
+        for (int u = 0; u < n_; ++u) {
+            if (offsets_[u + 1] < offsets_[u]) throw std::runtime_error("MappedGraph::verify: offsets are not monotonic");
+        }
+        const int64_t arcs = offsets_[n_];
+        for (int64_t a = 0; a < arcs; ++a) {
+            if (edges_[a].to < 0 || edges_[a].to >= n_) {
+                throw std::runtime_error("MappedGraph::verify: arc target out of range");
+            }
+            if (edges_[a].weight < 0) throw std::runtime_error("MappedGraph::verify: negative arc weight");
+        }
+    }
+
+    const int64_t* offsets() const { return offsets_; }
+    const Graph::Edge* edges() const { return edges_; }
+
+private:
+    const char* base_;
+    size_t size_;
+    int n_ = 0;
+    bool directed_ = false;
+    const int64_t* offsets_ = nullptr;
+    const Graph::Edge* edges_ = nullptr;
+
+    void validate(const std::string& path) {
+        GraphFileHeader header;
+        std::memcpy(&header, base_, sizeof(header));
+
+        if (std::memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("MappedGraph: not a graph file: " + path);
+        }
+        if (header.version != GRAPH_FILE_VERSION) {
+            throw std::runtime_error("MappedGraph: unsupported graph file version in " + path);
+        }
+        const int64_t fileSize = static_cast<int64_t>(size_);
+        if (header.n < 0 || header.n > INT_MAX || header.arcs < 0 ||
+            header.offsetsPos < static_cast<int64_t>(sizeof(GraphFileHeader)) || header.edgesPos < 0 ||
+            header.offsetsPos % 64 != 0 || header.edgesPos % 64 != 0) {
+            throw std::runtime_error("MappedGraph: corrupt header in " + path);
+        }
+
+        //in signed 64 bit, every term is bounded by the file size before it
+        //is multiplied or added, so nothing can wrap
+        if (header.offsetsPos > fileSize || header.edgesPos > fileSize ||
+            header.n + 1 > (fileSize - header.offsetsPos) / static_cast<int64_t>(sizeof(int64_t)) ||
+            header.arcs > (fileSize - header.edgesPos) / static_cast<int64_t>(sizeof(Graph::Edge))) {
+            throw std::runtime_error("MappedGraph: file is truncated: " + path);
+        }
+        const int64_t offsetsEnd = header.offsetsPos + (header.n + 1) * static_cast<int64_t>(sizeof(int64_t));
+        if (offsetsEnd > header.edgesPos) {
+            throw std::runtime_error("MappedGraph: corrupt header in " + path);
+        }
+
+        n_ = static_cast<int>(header.n);
+        directed_ = (header.flags & GRAPH_FILE_DIRECTED) != 0;
+        offsets_ = reinterpret_cast<const int64_t*>(base_ + header.offsetsPos);
+        edges_ = reinterpret_cast<const Graph::Edge*>(base_ + header.edgesPos);
+
+        if (offsets_[0] != 0 || offsets_[n_] != header.arcs) {
+            throw std::runtime_error("MappedGraph: offsets do not match edge count in " + path);
+        }
+    }
+};
+
+#endif
@@ -2,22 +2,28 @@
 #define GRAPHGEN_H
 
 #include "graph.h"
+#include "csrGraph.h"
+#include "threadPool.h"
 #include <random>
 #include <algorithm>
 #include <vector>
-#include <set>
+#include <unordered_set>
 #include <cmath>
+#include <cstdint>
+#include <atomic>
+#include <stdexcept>
 
 using namespace std;
 
 //random sparse graph
-inline Graph generateRandom(int n, bool directed, int targetEdges, int maxWeight = 1000) {
+inline Graph generateRandom(int n, bool directed, int targetEdges, int maxWeight = 1000, unsigned seed = 67) {
     Graph g(n, directed);
-    mt19937 rng(67); //67
+    mt19937 rng(seed); //67
     uniform_int_distribution<int> weightDist(1, maxWeight); //random edge weight range
 
-    //track existing edges to avoid duplicates
-    set<pair<int,int>> edges;
+    //track existing edges to avoid duplicates, packed as lo * n + hi
+    unordered_set<long long> edges;
+    edges.reserve(static_cast<size_t>(max(targetEdges, n)));
 
     //random order for verticies
     vector<int> order(n);
@@ -32,7 +38,7 @@ inline Graph generateRandom(int n, bool directed, int targetEdges, int maxWeight
         int w = weightDist(rng);
 
         g.add_edge(u, v, w);
-        edges.insert({min(u,v), max(u,v)});
+        edges.insert(static_cast<long long>(min(u,v)) * n + max(u,v));
     }
 
     //add target edges (lot for dense, few for sparse)
@@ -43,7 +49,7 @@ inline Graph generateRandom(int n, bool directed, int targetEdges, int maxWeight
         int v = rng() % n;
         if (u == v) continue;
 
-        auto key = make_pair(min(u,v), max(u,v));
+        long long key = static_cast<long long>(min(u,v)) * n + max(u,v);
         if (edges.count(key)) continue;
 
         g.add_edge(u, v, weightDist(rng));
@@ -55,10 +61,10 @@ inline Graph generateRandom(int n, bool directed, int targetEdges, int maxWeight
 }
 
 //grid
-inline Graph generateGrid(int rows, int cols, bool directed, int maxWeight = 1000) {
+inline Graph generateGrid(int rows, int cols, bool directed, int maxWeight = 1000, unsigned seed = 42) {
     int n = rows * cols;
     Graph g(n, directed);
-    mt19937 rng(42);
+    mt19937 rng(seed);
     uniform_int_distribution<int> weightDist(1, maxWeight);
 
     for (int r = 0; r < rows; r++) {
@@ -100,4 +106,223 @@ inline Graph generateWorstCase(int n, bool directed, int maxWeight = 1000) {
     return g;
 }
 
+//counter based random numbers (splitmix64 finalizer over seed, stream, counter)
+//a draw does not depend on any earlier draw, so threads can make any draw in
+//any order and still get the same graph for a seed
+inline uint64_t counterRandom(uint64_t seed, uint64_t stream, uint64_t counter) {
+    uint64_t z = seed * 0x9E3779B97F4A7C15ULL + stream * 0xD1B54A32D192ED03ULL + counter;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct GenEdge {
+    int u;
+    int v;
+    int weight;
+    long long rank; //tree edges are -1, extra edges their draw counter
+};
+
+//counting sort items into one run per vertex key(e), then sort every run with
+//less in parallel. the scatter order is thread dependent but less is a total
+//order, so the result is not. returns the run offsets
+template<typename Key, typename Less>
+inline vector<long long> groupByVertex(int n, vector<GenEdge>& items, Key key, Less less, ThreadPool& pool) {
+    const size_t GRAIN = 1 << 14;
+    vector<atomic<long long>> fill(n);
+    for (auto& f : fill) f.store(0, memory_order_relaxed);
+
+    pool.parallel_for(items.size(), GRAIN, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) fill[key(items[i])].fetch_add(1, memory_order_relaxed);
+    });
+
+    vector<long long> offsets(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        offsets[u + 1] = offsets[u] + fill[u].load(memory_order_relaxed);
+        fill[u].store(offsets[u], memory_order_relaxed);
+    }
+
+    vector<GenEdge> out(items.size());
+    pool.parallel_for(items.size(), GRAIN, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            out[fill[key(items[i])].fetch_add(1, memory_order_relaxed)] = items[i];
+        }
+    });
+    items.swap(out);
+
+    pool.parallel_for(n, 256, [&](size_t begin, size_t end, int) {
+        for (size_t u = begin; u < end; ++u) {
+            sort(items.begin() + offsets[u], items.begin() + offsets[u + 1], less);
+        }
+    });
+    return offsets;
+}
+
+//random graph straight to csr: a random spanning tree plus extra edges
+//like generateRandom, but duplicates are removed by grouping and sorting per
+//vertex instead of a set, and every draw comes from counterRandom, so
+//generation runs on all threads and the graph only depends on seed, never on
+//the thread count. the extra edges are the first distinct non tree pairs in
+//draw order
+inline CSRGraph generateRandomCSR(int n, bool directed, long long targetEdges, int maxWeight = 1000,
+                                  uint64_t seed = 67, int threads = 1) {
+    if (n < 1) throw invalid_argument("generateRandomCSR: n must be >= 1");
+    const long long maxEdges = static_cast<long long>(n) * (n - 1) / 2;
+    if (targetEdges > maxEdges) throw invalid_argument("generateRandomCSR: more edges than vertex pairs");
+    if (targetEdges < n - 1) targetEdges = n - 1;
+
+    ThreadPool pool(threads);
+    const size_t GRAIN = 1 << 14;
+
+    //random vertex order from sorted random keys
+    vector<pair<uint64_t, int>> keyed(n);
+    pool.parallel_for(n, GRAIN, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) keyed[i] = {counterRandom(seed, 0, i), static_cast<int>(i)};
+    });
+    parallel_sort(keyed, pool, [](const pair<uint64_t, int>& a, const pair<uint64_t, int>& b) { return a < b; });
+
+    //spanning tree, the i-th vertex in order hangs off a random earlier one
+    vector<GenEdge> all(n - 1);
+    pool.parallel_for(n - 1, GRAIN, [&](size_t begin, size_t end, int) {
+        for (size_t k = begin; k < end; ++k) {
+            const size_t i = k + 1;
+            const uint64_t r = counterRandom(seed, 1, i);
+            const int u = keyed[i].second;
+            const int v = keyed[(r >> 32) % i].second;
+            all[k] = {u, v, 1 + static_cast<int>((r & 0xffffffffu) % maxWeight), -1};
+        }
+    });
+    vector<pair<uint64_t, int>>().swap(keyed);
+
+    auto lowEnd = [](const GenEdge& e) { return min(e.u, e.v); };
+    auto byHighThenRank = [](const GenEdge& a, const GenEdge& b) {
+        int ahi = max(a.u, a.v), bhi = max(b.u, b.v);
+        return ahi != bhi ? ahi < bhi : a.rank < b.rank;
+    };
+
+    //draw extra edges in batches, dedup against everything so far keeping the
+    //earliest draw of each pair, until there are enough
+    long long drawn = 0;
+    long long have = n - 1;
+    while (have < targetEdges) {
+        //expected new pairs from b draws is free * (1 - e^(-b / maxEdges)),
+        //solve for b so one batch is nearly always enough
+        const long long need = targetEdges - have;
+        const double freePairs = static_cast<double>(maxEdges - have);
+        const double share = min(static_cast<double>(need) / freePairs, 1.0 - 1e-9);
+        long long batch = static_cast<long long>(-log(1.0 - share) * maxEdges * 1.02 * n / max(n - 1, 1)) + 1024;
+        batch = min(batch, 4 * maxEdges + 1024);
+
+        size_t base = all.size();
+        all.resize(base + batch);
+        pool.parallel_for(batch, GRAIN, [&](size_t begin, size_t end, int) {
+            for (size_t k = begin; k < end; ++k) {
+                const long long c = drawn + static_cast<long long>(k);
+                const uint64_t r = counterRandom(seed, 2, c);
+                int u = static_cast<int>((r >> 32) % n);
+                int v = static_cast<int>((r & 0xffffffffu) % n);
+                int w = 1 + static_cast<int>(counterRandom(seed, 3, c) % maxWeight);
+                all[base + k] = {u, v, w, c};
+            }
+        });
+        drawn += batch;
+
+        //per low vertex: drop self loops and every later copy of a pair
+        vector<long long> offsets = groupByVertex(n, all, lowEnd, byHighThenRank, pool);
+        vector<long long> kept(n + 1, 0);
+        pool.parallel_for(n, 256, [&](size_t begin, size_t end, int) {
+            for (size_t u = begin; u < end; ++u) {
+                long long out = offsets[u];
+                for (long long i = offsets[u]; i < offsets[u + 1]; ++i) {
+                    const GenEdge& e = all[i];
+                    if (e.u == e.v) continue;
+                    if (out > offsets[u] && max(all[out - 1].u, all[out - 1].v) == max(e.u, e.v)) continue;
+                    all[out++] = e;
+                }
+                kept[u + 1] = out - offsets[u];
+            }
+        });
+        for (int u = 0; u < n; ++u) kept[u + 1] += kept[u];
+
+        vector<GenEdge> compact(kept[n]);
+        pool.parallel_for(n, 256, [&](size_t begin, size_t end, int) {
+            for (size_t u = begin; u < end; ++u) {
+                copy(all.begin() + offsets[u], all.begin() + offsets[u] + (kept[u + 1] - kept[u]),
+                     compact.begin() + kept[u]);
+            }
+        });
+        all.swap(compact);
+        have = static_cast<long long>(all.size());
+    }
+
+    //too many, drop the latest draws
+    if (have > targetEdges) {
+        vector<long long> ranks(all.size());
+        for (size_t i = 0; i < all.size(); ++i) ranks[i] = all[i].rank;
+        nth_element(ranks.begin(), ranks.begin() + (targetEdges - 1), ranks.end());
+        const long long cutoff = ranks[targetEdges - 1];
+        all.erase(remove_if(all.begin(), all.end(), [&](const GenEdge& e) { return e.rank > cutoff; }), all.end());
+    }
+
+    if (!directed) {
+        size_t m = all.size();
+        all.resize(2 * m);
+        pool.parallel_for(m, GRAIN, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; ++i) all[m + i] = {all[i].v, all[i].u, all[i].weight, all[i].rank};
+        });
+    }
+
+    //arcs by source, each source's arcs by target
+    vector<long long> offsets = groupByVertex(n, all, [](const GenEdge& e) { return e.u; },
+                                              [](const GenEdge& a, const GenEdge& b) { return a.v < b.v; }, pool);
+    vector<Graph::Edge> edges(all.size());
+    pool.parallel_for(all.size(), GRAIN, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) edges[i] = {all[i].v, all[i].weight};
+    });
+
+    return CSRGraph(n, directed, move(offsets), move(edges));
+}
+
+//grid straight to csr, same shape and neighbor order (up, left, right, down)
+//as generateGrid. weights come from counterRandom keyed by the edge, so both
+//directions of an undirected edge agree and any thread can write any row
+inline CSRGraph generateGridCSR(int rows, int cols, bool directed, int maxWeight = 1000,
+                                uint64_t seed = 42, int threads = 1) {
+    if (rows < 0 || cols < 0) throw invalid_argument("generateGridCSR: rows and cols must be >= 0");
+    const int n = rows * cols;
+    ThreadPool pool(threads);
+
+    //edge 2u goes right from u, edge 2u+1 goes down from u
+    auto weight = [&](long long edgeId) {
+        return 1 + static_cast<int>(counterRandom(seed, 4, edgeId) % maxWeight);
+    };
+
+    vector<long long> offsets(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        int r = u / cols, c = u % cols;
+        int deg = (c + 1 < cols) + (r + 1 < rows);
+        if (!directed) deg += (c > 0) + (r > 0);
+        offsets[u + 1] = offsets[u] + deg;
+    }
+
+    vector<Graph::Edge> edges(offsets[n]);
+    pool.parallel_for(rows, 64, [&](size_t begin, size_t end, int) {
+        for (size_t r = begin; r < end; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                const int u = static_cast<int>(r) * cols + c;
+                long long pos = offsets[u];
+                if (!directed && r > 0) edges[pos++] = {u - cols, weight(2LL * (u - cols) + 1)};
+                if (!directed && c > 0) edges[pos++] = {u - 1, weight(2LL * (u - 1))};
+                if (c + 1 < cols) edges[pos++] = {u + 1, weight(2LL * u)};
+                if (static_cast<int>(r) + 1 < rows) edges[pos++] = {u + cols, weight(2LL * u + 1)};
+            }
+        }
+    });
+
+    return CSRGraph(n, directed, move(offsets), move(edges));
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef HEAP_SELECT_H
+#define HEAP_SELECT_H
+
+#include "fibonacciHeap.h"
+#include "pairingHeap.h"
+#include "daryHeap.h"
+#include "radixHeap.h"
+#include "rankPairingHeap.h"
+#include "hollowHeap.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//every name withHeap knows, in the order the benchmarks list them
+inline const std::vector<std::string>& heapNames() {
+    static const std::vector<std::string> names = {
+        "fibonacci", "pairing", "pairing_multipass", "pairing_aux", "rank_pairing", "hollow",
+        "dary2", "dary4", "dary8", "radix"};
+    return names;
+}
+
+//stands for a heap type without building one
+template<typename PQ>
+struct HeapType {
+    using type = PQ;
+};
+
+//hand f a HeapType<PQ> for the heap named by heapType, for callers that
+//build their own heaps (one per thread, say) and only need the type
+//any name from heapNames()
+template<typename F>
+inline void withHeapType(const std::string& heapType, F f) {
+    if (heapType == "fibonacci") {
+        f(HeapType<FibonacciHeap<long long, int>>());
+    } else if (heapType == "pairing") {
+        f(HeapType<PairingHeap<long long, int>>());
+    } else if (heapType == "pairing_multipass") {
+        f(HeapType<PairingHeap<long long, int, PAIRING_MULTIPASS>>());
+    } else if (heapType == "pairing_aux") {
+        f(HeapType<PairingHeap<long long, int, PAIRING_AUX_TWO_PASS>>());
+    } else if (heapType == "rank_pairing") {
+        f(HeapType<RankPairingHeap<long long, int>>());
+    } else if (heapType == "hollow") {
+        f(HeapType<HollowHeap<long long, int>>());
+    } else if (heapType == "dary2") {
+        f(HeapType<DaryHeap<long long, int, 2>>());
+    } else if (heapType == "dary4") {
+        f(HeapType<DaryHeap<long long, int, 4>>());
+    } else if (heapType == "dary8") {
+        f(HeapType<DaryHeap<long long, int, 8>>());
+    } else if (heapType == "radix") {
+        f(HeapType<RadixHeap<int>>());
+    } else {
+        throw std::invalid_argument("unknown heap: " + heapType);
+    }
+}
+
+//build the heap named by heapType and hand it to f as its concrete type
+//any name from heapNames()
+//radix is monotone so it only works for dijkstra
+template<typename F>
+inline void withHeap(const std::string& heapType, F f) {
+    withHeapType(heapType, [&](auto tag) {
+        typename decltype(tag)::type pq;
+        f(pq);
+    });
+}
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef HEAP_STATS_H
+#define HEAP_STATS_H
+
+#include <chrono>
+#include <cstdint>
+
+//per operation instrumentation for the heaps, off unless built with
+//-DPQ_INSTRUMENT. switched off, PriorityQueue carries no stats at all and the
+//hooks in the heaps fold away to nothing
+#ifdef PQ_INSTRUMENT
+const bool PQ_INSTRUMENTED = true;
+#else
+const bool PQ_INSTRUMENTED = false;
+#endif
+
+//only every PQ_SAMPLE_EVERY-th call of an operation is timed, reading the
+//clock on every call would cost more than most decrease_keys
+#ifndef PQ_SAMPLE_EVERY
+#define PQ_SAMPLE_EVERY 64
+#endif
+
+//latency histogram in nanoseconds with four buckets per power of two, so
+//any percentile is within 25% of the true value. values 0..3 are exact
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 256;
+
+    LatencyHistogram() { reset(); }
+
+    void reset() {
+        for (int i = 0; i < BUCKETS; ++i) buckets_[i] = 0;
+        calls_ = 0;
+        samples_ = 0;
+        max_ = 0;
+    }
+
+    void record(uint64_t ns) {
+        buckets_[bucketOf(ns)]++;
+        samples_++;
+        if (ns > max_) max_ = ns;
+    }
+
+    //add another histogram's samples, e.g. from a repeated run
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < BUCKETS; ++i) buckets_[i] += other.buckets_[i];
+        samples_ += other.samples_;
+        if (other.max_ > max_) max_ = other.max_;
+    }
+
+    //true on the calls that should be timed
+    bool sampleNext() { return ++calls_ % PQ_SAMPLE_EVERY == 0; }
+
+    uint64_t samples() const { return samples_; }
+    uint64_t max() const { return max_; }
+
+    //upper edge of the bucket holding the p-th sample, p in [0, 1]
+    uint64_t percentile(double p) const {
+        if (samples_ == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p * (samples_ - 1));
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets_[i];
+            if (seen > rank) {
+                uint64_t edge = upperEdge(i);
+                return edge < max_ ? edge : max_;
+            }
+        }
+        return max_;
+    }
+
+private:
+    uint64_t buckets_[BUCKETS];
+    uint64_t calls_;
+    uint64_t samples_;
+    uint64_t max_;
+
+    static int bucketOf(uint64_t v) {
+        if (v < 4) return static_cast<int>(v);
+        int e = 63 - __builtin_clzll(v);
+        int sub = static_cast<int>((v >> (e - 2)) & 3);
+        return (e - 1) * 4 + sub;
+    }
+
+    static uint64_t upperEdge(int i) {
+        if (i < 4) return static_cast<uint64_t>(i);
+        int e = i / 4 + 1;
+        uint64_t sub = static_cast<uint64_t>(i % 4);
+        if (e == 63 && sub == 3) return UINT64_MAX;
+        return ((4 + sub + 1) << (e - 2)) - 1;
+    }
+};
+
+//running count, total and max of one structural quantity
+struct StructureStat {
+    long long count = 0;
+    long long total = 0;
+    long long max = 0;
+
+    void record(long long v) {
+        count++;
+        total += v;
+        if (v > max) max = v;
+    }
+
+    void merge(const StructureStat& other) {
+        count += other.count;
+        total += other.total;
+        if (other.max > max) max = other.max;
+    }
+
+    double mean() const { return count == 0 ? 0 : static_cast<double>(total) / count; }
+};
+
+//what every PriorityQueue carries when instrumented
+//structure is heap specific, each heap says in its own header what it records
+struct HeapStats {
+    LatencyHistogram insert;
+    LatencyHistogram extract;
+    LatencyHistogram decreaseKey;
+    StructureStat structure;
+
+    void reset() {
+        insert.reset();
+        extract.reset();
+        decreaseKey.reset();
+        structure = StructureStat();
+    }
+
+    void merge(const HeapStats& other) {
+        insert.merge(other.insert);
+        extract.merge(other.extract);
+        decreaseKey.merge(other.decreaseKey);
+        structure.merge(other.structure);
+    }
+};
+
+//times the enclosing operation into h if this call is sampled
+//h is null when instrumentation is off
+class OpTimer {
+public:
+    explicit OpTimer(LatencyHistogram* h) : hist_(nullptr) {
+        if (PQ_INSTRUMENTED && h != nullptr && h->sampleNext()) {
+            hist_ = h;
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    OpTimer(const OpTimer&) = delete;
+    OpTimer& operator=(const OpTimer&) = delete;
+
+    ~OpTimer() {
+        if (PQ_INSTRUMENTED && hist_ != nullptr) {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+            hist_->record(static_cast<uint64_t>(ns.count()));
+        }
+    }
+
+private:
+    LatencyHistogram* hist_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#endif
@@ -0,0 +1,361 @@
+#ifndef HEAP_TRACE_H
+#define HEAP_TRACE_H
+
+#include "priorityQueue.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+//binary heap operation trace, version 1
+//  header  HeapTraceHeader, 32 bytes
+//  ops     one per heap call, a 1 byte opcode then LEB128 varints
+//            insert        key
+//            decrease_key  id, key
+//            extract_min   id, key   (what came out)
+//            reset         nothing
+//ids are handed out in insert order starting from 0 and start again after a
+//reset. keys are zigzag encoded differences from the previous key in the
+//trace, so the usual slowly growing dijkstra keys take a byte or two
+//values are not recorded, replay only needs the ids
+const char HEAP_TRACE_MAGIC[8] = {'C', 'S', '4', '7', '0', 'T', 'R', 'C'};
+const uint32_t HEAP_TRACE_VERSION = 1;
+
+enum HeapTraceOpcode : uint8_t {
+    TRACE_INSERT = 0,
+    TRACE_DECREASE_KEY = 1,
+    TRACE_EXTRACT_MIN = 2,
+    TRACE_RESET = 3
+};
+
+struct HeapTraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t ops;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(HeapTraceHeader) == 32, "HeapTraceHeader must stay 32 bytes");
+
+//appends operations to a trace file through a write buffer
+//the op count in the header is filled in by close(), which the destructor
+//calls if nobody did
+class TraceWriter {
+public:
+    explicit TraceWriter(const std::string& path)
+        : path_(path), out_(path, std::ios::binary | std::ios::trunc), ops_(0), lastKey_(0) {
+        if (!out_) throw std::runtime_error("TraceWriter: cannot open " + path);
+        HeapTraceHeader header = makeHeader();
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        buf_.reserve(BUFFER);
+    }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    ~TraceWriter() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    void insert(long long key) {
+        op(TRACE_INSERT);
+        keyDelta(key);
+    }
+
+    void decreaseKey(long long id, long long key) {
+        op(TRACE_DECREASE_KEY);
+        varint(static_cast<uint64_t>(id));
+        keyDelta(key);
+    }
+
+    void extractMin(long long id, long long key) {
+        op(TRACE_EXTRACT_MIN);
+        varint(static_cast<uint64_t>(id));
+        keyDelta(key);
+    }
+
+    void reset() { op(TRACE_RESET); }
+
+    long long ops() const { return ops_; }
+
+    void close() {
+        if (!out_.is_open()) return;
+        flush();
+        HeapTraceHeader header = makeHeader();
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out_.close();
+        if (!out_) throw std::runtime_error("TraceWriter: write failed for " + path_);
+    }
+
+private:
+    static const size_t BUFFER = 1 << 20;
+
+    std::string path_;
+    std::ofstream out_;
+    std::vector<char> buf_;
+    long long ops_;
+    long long lastKey_;
+
+    HeapTraceHeader makeHeader() const {
+        HeapTraceHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, HEAP_TRACE_MAGIC, sizeof(header.magic));
+        header.version = HEAP_TRACE_VERSION;
+        header.ops = static_cast<uint64_t>(ops_);
+        return header;
+    }
+
+    void op(HeapTraceOpcode code) {
+        if (buf_.size() + 32 > BUFFER) flush();
+        buf_.push_back(static_cast<char>(code));
+        ops_++;
+    }
+
+    void varint(uint64_t x) {
+        while (x >= 0x80) {
+            buf_.push_back(static_cast<char>((x & 0x7f) | 0x80));
+            x >>= 7;
+        }
+        buf_.push_back(static_cast<char>(x));
+    }
+
+    void keyDelta(long long key) {
+        uint64_t d = static_cast<uint64_t>(key) - static_cast<uint64_t>(lastKey_);
+        lastKey_ = key;
+        //zigzag, small negative differences stay small
+        varint((d << 1) ^ (0 - (d >> 63)));
+    }
+
+    void flush() {
+        out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+        buf_.clear();
+    }
+};
+
+//one decoded operation, id is -1 for insert (implicit) and reset
+struct TraceOp {
+    uint8_t op;
+    int id;
+    long long key;
+};
+
+//a whole trace decoded into memory so replay spends no time parsing
+struct HeapTrace {
+    std::vector<TraceOp> ops;
+    int maxIds = 0;  //most inserts between two resets, sizes the replay tables
+};
+
+inline HeapTrace readTrace(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("readTrace: cannot open " + path);
+
+    HeapTraceHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("readTrace: file too small for a header: " + path);
+    }
+    if (std::memcmp(header.magic, HEAP_TRACE_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("readTrace: not a heap trace: " + path);
+    }
+    if (header.version != HEAP_TRACE_VERSION) {
+        throw std::runtime_error("readTrace: unsupported trace version in " + path);
+    }
+
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t pos = 0;
+    auto varint = [&]() {
+        uint64_t x = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= bytes.size()) throw std::runtime_error("readTrace: trace is truncated: " + path);
+            uint8_t b = static_cast<uint8_t>(bytes[pos++]);
+            x |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) return x;
+        }
+        throw std::runtime_error("readTrace: bad varint in " + path);
+    };
+
+    HeapTrace trace;
+    trace.ops.reserve(header.ops);
+    uint64_t lastKey = 0;
+    int ids = 0;
+    auto key = [&]() {
+        uint64_t z = varint();
+        lastKey += (z >> 1) ^ (0 - (z & 1));
+        return static_cast<long long>(lastKey);
+    };
+    auto id = [&]() {
+        uint64_t x = varint();
+        if (x >= static_cast<uint64_t>(ids)) throw std::runtime_error("readTrace: id never inserted in " + path);
+        return static_cast<int>(x);
+    };
+
+    for (uint64_t i = 0; i < header.ops; ++i) {
+        if (pos >= bytes.size()) throw std::runtime_error("readTrace: trace is truncated: " + path);
+        TraceOp op;
+        op.op = static_cast<uint8_t>(bytes[pos++]);
+        op.id = -1;
+        op.key = 0;
+        switch (op.op) {
+            case TRACE_INSERT:
+                if (ids == INT_MAX) throw std::runtime_error("readTrace: too many inserts between resets in " + path);
+                op.key = key();
+                ids++;
+                break;
+            case TRACE_DECREASE_KEY:
+            case TRACE_EXTRACT_MIN:
+                op.id = id();
+                op.key = key();
+                break;
+            case TRACE_RESET:
+                ids = 0;
+                break;
+            default:
+                throw std::runtime_error("readTrace: unknown opcode in " + path);
+        }
+        if (ids > trace.maxIds) trace.maxIds = ids;
+        trace.ops.push_back(op);
+    }
+    return trace;
+}
+
+//PriorityQueue wrapper that writes every insert, decrease_key, extract_min
+//and reset to a trace and forwards it to the inner heap
+//the inner heap gets the trace id as its value, the caller's value is kept
+//here and handed back on extract_min. works as a PriorityQueue (virtual) or
+//as a concrete type in dijkstra() and prim_mst()
+template<typename PQ>
+class RecordingHeap final : public PriorityQueue<long long, int> {
+public:
+    RecordingHeap(PQ& inner, TraceWriter& out) : inner_(inner), out_(out) {}
+
+    Node<long long, int>* insert(long long key, int value) override {
+        this->insertCount++;
+        const long long id = static_cast<long long>(entries_.size());
+        if (id == INT_MAX) throw std::length_error("RecordingHeap: too many inserts between resets");
+
+        entries_.emplace_back();
+        Entry& e = entries_.back();
+        e.key = key;
+        e.value = value;
+        e.id = static_cast<int>(id);
+        e.inner = inner_.insert(key, e.id);
+        out_.insert(key);
+        return &e;
+    }
+
+    void decrease_key(Node<long long, int>* node, long long new_key) override {
+        this->decreaseKeyCount++;
+        Entry* e = static_cast<Entry*>(node);
+        inner_.decrease_key(e->inner, new_key);
+        e->key = new_key;
+        out_.decreaseKey(e->id, new_key);
+    }
+
+    pair<long long, int> extract_min() override {
+        this->extractCount++;
+        auto [key, id] = inner_.extract_min();
+        out_.extractMin(id, key);
+        return {key, entries_[id].value};
+    }
+
+    pair<long long, int> find_min() override {
+        auto [key, id] = inner_.find_min();
+        return {key, entries_[id].value};
+    }
+
+    bool is_empty() override { return inner_.is_empty(); }
+
+    void reset() override {
+        inner_.reset();
+        entries_.clear();
+        out_.reset();
+        this->resetCounters();
+    }
+
+private:
+    using Handle = pq_handle_t<PQ, long long, int>;
+
+    struct Entry : Node<long long, int> {
+        Handle inner;
+        int id;
+    };
+
+    PQ& inner_;
+    TraceWriter& out_;
+    std::deque<Entry> entries_;  //indexed by id, addresses stay put
+};
+
+//drives a heap through a recorded trace with no graph in sight
+//the heap gets trace ids as values. when two keys tie a heap may extract a
+//different id than the recording did; both have the same key, so the live
+//one simply takes over the extracted id and the rest of the trace stays
+//valid. a different key coming out means the heap is broken and throws
+//the tables are kept between runs so repeated replays do not allocate
+template<typename PQ>
+class TraceReplayer {
+public:
+    //returns a checksum of the extracted keys
+    uint64_t run(const HeapTrace& trace, PQ& pq) {
+        handleOf_.resize(trace.maxIds);
+        heapIdOf_.resize(trace.maxIds);
+        traceIdOf_.resize(trace.maxIds);
+
+        uint64_t checksum = 0;
+        int next = 0;
+        for (const TraceOp& op : trace.ops) {
+            switch (op.op) {
+                case TRACE_INSERT:
+                    handleOf_[next] = pq.insert(op.key, next);
+                    heapIdOf_[next] = next;
+                    traceIdOf_[next] = next;
+                    next++;
+                    break;
+                case TRACE_DECREASE_KEY:
+                    pq.decrease_key(handleOf_[op.id], op.key);
+                    break;
+                case TRACE_EXTRACT_MIN: {
+                    auto [key, heapId] = pq.extract_min();
+                    if (key != op.key) {
+                        throw std::runtime_error("TraceReplayer: heap returned key " + std::to_string(key) +
+                                                 ", trace expected " + std::to_string(op.key));
+                    }
+                    const int got = traceIdOf_[heapId];
+                    if (got != op.id) {
+                        //the recording's pick is still live here, it becomes got
+                        const int live = heapIdOf_[op.id];
+                        handleOf_[got] = handleOf_[op.id];
+                        heapIdOf_[got] = live;
+                        traceIdOf_[live] = got;
+                    }
+                    checksum = checksum * 31 + static_cast<uint64_t>(key);
+                    break;
+                }
+                case TRACE_RESET:
+                    pq.reset();
+                    next = 0;
+                    break;
+            }
+        }
+        return checksum;
+    }
+
+private:
+    using Handle = pq_handle_t<PQ, long long, int>;
+
+    std::vector<Handle> handleOf_;  //trace id -> handle
+    std::vector<int> heapIdOf_;     //trace id -> value the heap holds for it
+    std::vector<int> traceIdOf_;    //value the heap holds -> trace id
+};
+
+#endif
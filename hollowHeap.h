@@ -0,0 +1,243 @@
+//interfaces to priorityQueue.h
+
+#ifndef HOLLOW_HEAP_H
+#define HOLLOW_HEAP_H
+
+#include "priorityQueue.h"
+#include "nodePool.h"
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template<typename K, typename V>
+struct HollowNode;
+
+//handle given back by insert, stays valid until its item is extracted even
+//though decrease_key moves the item to a new node
+template<typename K, typename V>
+struct HollowItem : public Node<K,V> {
+    HollowNode<K,V>* node;
+
+    HollowItem(K k, V v) : node(nullptr) {
+        this->key = k;
+        this->value = v;
+    }
+};
+
+//item is null once the node is hollow
+//a node has one parent through the child/next lists, plus a second parent sp
+//if decrease_key left it hollow under the node that took its item
+template<typename K, typename V>
+struct HollowNode {
+    HollowItem<K,V>* item;
+    HollowNode* child;
+    HollowNode* next;
+    HollowNode* sp;
+    K key;
+    int rank;
+
+    HollowNode(HollowItem<K,V>* e, K k)
+        : item(e), child(nullptr), next(nullptr), sp(nullptr), key(k), rank(0) {}
+};
+
+//hollow heap, one root, two parent variant (hansen, kaplan, tarjan and zwick)
+//decrease_key never restructures: the item moves to a new node that is linked
+//with the root, and the old node is left hollow in place, keeping its
+//children. hollow nodes are only cleaned up when extract_min walks into them
+//O(1) insert and decrease_key, O(log n) amortized extract_min
+//structure stat (PQ_INSTRUMENT builds): hollow nodes freed by each extract_min
+template<typename K, typename V>
+class HollowHeap final : public PriorityQueue<K,V> {
+private:
+    HollowNode<K,V>* root_;
+    NodePool<HollowNode<K,V>> nodes_;
+    NodePool<HollowItem<K,V>> items_;
+
+    //full roots by rank during extract_min, kept between calls
+    vector<HollowNode<K,V>*> ranked_;
+
+    //the larger key becomes the first child of the smaller
+    static HollowNode<K,V>* link(HollowNode<K,V>* v, HollowNode<K,V>* w) {
+        if (v->key >= w->key) {
+            addChild(v, w);
+            return w;
+        }
+        addChild(w, v);
+        return v;
+    }
+
+    static void addChild(HollowNode<K,V>* v, HollowNode<K,V>* w) {
+        v->next = w->child;
+        w->child = v;
+    }
+
+    HollowNode<K,V>* makeNode(HollowItem<K,V>* e, K key) {
+        HollowNode<K,V>* u = nodes_.acquire(e, key);
+        e->node = u;
+        return u;
+    }
+
+    //every node reachable from the root exactly once, without recursion
+    //a node with two parents is taken from whichever parent comes second
+    void deleteAll(HollowNode<K,V>* h) {
+        if (h == nullptr) return;
+        h->next = nullptr;
+        while (h != nullptr) {
+            HollowNode<K,V>* x = h;
+            h = h->next;
+            for (HollowNode<K,V>* w = x->child; w != nullptr;) {
+                HollowNode<K,V>* y = w;
+                w = w->next;
+                if (y->sp == nullptr) {
+                    y->next = h;
+                    h = y;
+                } else {
+                    if (y->sp == x) {
+                        w = nullptr;
+                    } else {
+                        y->next = nullptr;
+                    }
+                    y->sp = nullptr;
+                }
+            }
+            if (x->item != nullptr) items_.release(x->item);
+            nodes_.release(x);
+        }
+    }
+
+    void releaseAll() {
+        if (!nodes_.skipRelease() || !items_.skipRelease()) deleteAll(root_);
+        root_ = nullptr;
+    }
+
+public:
+    //pooled = false allocates every node and item with new
+    explicit HollowHeap(bool pooled = true) : root_(nullptr), nodes_(pooled), items_(pooled) {}
+
+    ~HollowHeap() override {
+        releaseAll();
+    }
+
+    void reset() override {
+        releaseAll();
+        nodes_.reset();
+        items_.reset();
+        this->resetCounters();
+    }
+
+    //times the system allocator was called for nodes and items
+    long long allocations() const { return nodes_.allocations() + items_.allocations(); }
+
+    bool is_empty() override {
+        return root_ == nullptr;
+    }
+
+    Node<K,V>* insert(K key, V value) override {
+        this->insertCount++;
+        OpTimer timer(this->insertHistogram());
+        HollowItem<K,V>* e = items_.acquire(key, value);
+        HollowNode<K,V>* u = makeNode(e, key);
+        root_ = root_ == nullptr ? u : link(u, root_);
+        return e;
+    }
+
+    pair<K,V> find_min() override {
+        if (root_ == nullptr) {
+            throw runtime_error("Heap is empty");
+        }
+        return {root_->key, root_->item->value};
+    }
+
+    pair<K,V> extract_min() override {
+        this->extractCount++;
+        OpTimer timer(this->extractHistogram());
+        if (root_ == nullptr) {
+            throw runtime_error("Heap is empty");
+        }
+
+        HollowItem<K,V>* e = root_->item;
+        pair<K,V> result = {root_->key, e->value};
+        root_->item = nullptr;
+        items_.release(e);
+
+        //walk the hollow nodes starting at the root. a hollow child with
+        //one parent is hollow for good and goes on the list, one with two
+        //parents just loses this one. full children are linked by rank
+        int maxRank = -1;
+        long long freed = 0;
+        HollowNode<K,V>* h = root_;
+        h->next = nullptr;
+        while (h != nullptr) {
+            HollowNode<K,V>* x = h;
+            h = h->next;
+            for (HollowNode<K,V>* w = x->child; w != nullptr;) {
+                HollowNode<K,V>* u = w;
+                w = w->next;
+                if (u->item == nullptr) {
+                    if (u->sp == nullptr) {
+                        u->next = h;
+                        h = u;
+                    } else {
+                        //x is u's second parent: u is x's last child and its
+                        //next belongs to the first parent's list
+                        if (u->sp == x) {
+                            w = nullptr;
+                        } else {
+                            u->next = nullptr;
+                        }
+                        u->sp = nullptr;
+                    }
+                } else {
+                    while (static_cast<size_t>(u->rank) < ranked_.size() && ranked_[u->rank] != nullptr) {
+                        HollowNode<K,V>* other = ranked_[u->rank];
+                        ranked_[u->rank] = nullptr;
+                        u = link(u, other);
+                        u->rank++;
+                    }
+                    if (static_cast<size_t>(u->rank) >= ranked_.size()) ranked_.resize(u->rank + 1, nullptr);
+                    ranked_[u->rank] = u;
+                    if (u->rank > maxRank) maxRank = u->rank;
+                }
+            }
+            nodes_.release(x);
+            freed++;
+        }
+        this->recordStructure(freed);
+
+        root_ = nullptr;
+        for (int i = 0; i <= maxRank; i++) {
+            if (ranked_[i] != nullptr) {
+                root_ = root_ == nullptr ? ranked_[i] : link(root_, ranked_[i]);
+                ranked_[i] = nullptr;
+            }
+        }
+        return result;
+    }
+
+    void decrease_key(Node<K,V>* node, K new_key) override {
+        this->decreaseKeyCount++;
+        OpTimer timer(this->decreaseKeyHistogram());
+        HollowItem<K,V>* e = static_cast<HollowItem<K,V>*>(node);
+        HollowNode<K,V>* u = e->node;
+
+        if (new_key > u->key) {
+            throw runtime_error("New key is greater than current key");
+        }
+
+        e->key = new_key;
+        if (u == root_) {
+            u->key = new_key;
+            return;
+        }
+
+        //move the item to a new node, u stays behind hollow as v's child
+        HollowNode<K,V>* v = makeNode(e, new_key);
+        u->item = nullptr;
+        if (u->rank > 2) v->rank = u->rank - 2;
+        v->child = u;
+        u->sp = v;
+        root_ = link(v, root_);
+    }
+};
+
+#endif
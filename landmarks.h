@@ -0,0 +1,301 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "astar.h"
+#include "batchQuery.h"
+#include "dijkstra.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+enum LandmarkSelection {
+    //each new landmark is the vertex farthest from the ones already picked
+    LANDMARKS_FARTHEST,
+    //goldberg and werneck's avoid: grow a shortest path tree from a random
+    //root, weigh every vertex by how badly the current landmarks bound its
+    //distance from the root, and walk down into the heaviest subtree that
+    //has no landmark yet. the leaf it ends on is the new landmark
+    LANDMARKS_AVOID
+};
+
+struct AltOptions {
+    int landmarks = 16;
+    LandmarkSelection selection = LANDMARKS_AVOID;
+    int threads = 1;        //for the distance tables, selection is sequential
+    unsigned seed = 1;
+};
+
+//landmark distance tables for alt (a*, landmarks, triangle inequality)
+//for every landmark L it keeps d(L, v) and, on a directed graph, d(v, L),
+//which bound any distance from below:
+//  d(v, t) >= d(L, t) - d(L, v)    and    d(v, t) >= d(v, L) - d(t, L)
+//T is the stored distance type, uint16_t or uint32_t. each landmark and
+//direction gets its own scale s so its largest distance fits, a distance d
+//is stored as floor(d / s) and the largest value of T means unreachable
+//rounding is paid for in the bound, so it stays a lower bound at any scale
+//but is only consistent (and radix safe) when every scale is 1
+//entries are stored vertex major, all of v's landmarks in one cache line
+template<typename T>
+class LandmarkTable {
+    static_assert(std::is_same<T, uint16_t>::value || std::is_same<T, uint32_t>::value,
+                  "LandmarkTable stores uint16_t or uint32_t distances");
+
+public:
+    static constexpr T UNREACHABLE = std::numeric_limits<T>::max();
+
+    LandmarkTable() : n_(0), directed_(false) {}
+
+    //select opts.landmarks landmarks and fill the tables with dijkstra_batch,
+    //forward from every landmark and on a directed graph backward as well,
+    //spread over opts.threads threads. PQ is the heap for all of it
+    template<typename PQ, typename GraphT>
+    static LandmarkTable build(const GraphT& g, const AltOptions& opts = AltOptions()) {
+        const int n = g.num_vertices();
+        if (opts.landmarks < 1) throw std::invalid_argument("LandmarkTable: need at least one landmark");
+        if (n == 0) throw std::invalid_argument("LandmarkTable: graph has no vertices");
+
+        LandmarkTable t;
+        t.n_ = n;
+        t.directed_ = g.directed();
+        t.landmarks_ = selectLandmarks<PQ>(g, std::min(opts.landmarks, n), opts.selection, opts.seed);
+
+        const int k = t.num_landmarks();
+        t.from_.assign(static_cast<size_t>(n) * k, UNREACHABLE);
+        t.fromScale_.assign(k, 1);
+        ThreadPool pool(opts.threads < 1 ? 1 : opts.threads);
+        dijkstra_batch<PQ>(g, t.landmarks_, pool, [&](size_t i, int, const DijkstraResult& r) {
+            t.fromScale_[i] = t.fill(t.from_, static_cast<int>(i), r.dist);
+        });
+
+        if (t.directed_) {
+            CSRGraph rev = reverseGraph(g);
+            t.to_.assign(static_cast<size_t>(n) * k, UNREACHABLE);
+            t.toScale_.assign(k, 1);
+            dijkstra_batch<PQ>(rev, t.landmarks_, pool, [&](size_t i, int, const DijkstraResult& r) {
+                t.toScale_[i] = t.fill(t.to_, static_cast<int>(i), r.dist);
+            });
+        }
+        return t;
+    }
+
+    int num_vertices() const { return n_; }
+    int num_landmarks() const { return static_cast<int>(landmarks_.size()); }
+    const std::vector<int>& landmarks() const { return landmarks_; }
+
+    //bytes held by the distance tables
+    size_t bytes() const { return (from_.size() + to_.size()) * sizeof(T); }
+
+    //lower bound on d(v, t) from landmark i, 0 if it has nothing to say
+    long long bound(int i, int v, int t) const {
+        const int k = num_landmarks();
+        long long best = 0;
+        //d(L, t) - d(L, v)
+        best = std::max(best, diff(from_[static_cast<size_t>(t) * k + i], from_[static_cast<size_t>(v) * k + i],
+                                   fromScale_[i]));
+        //d(v, L) - d(t, L), the same table when undirected
+        if (directed_) {
+            best = std::max(best, diff(to_[static_cast<size_t>(v) * k + i], to_[static_cast<size_t>(t) * k + i],
+                                       toScale_[i]));
+        } else {
+            best = std::max(best, diff(from_[static_cast<size_t>(v) * k + i], from_[static_cast<size_t>(t) * k + i],
+                                       fromScale_[i]));
+        }
+        return best;
+    }
+
+    //best bound over every landmark
+    long long lowerBound(int v, int t) const {
+        long long best = 0;
+        for (int i = 0; i < num_landmarks(); ++i) best = std::max(best, bound(i, v, t));
+        return best;
+    }
+
+private:
+    int n_;
+    bool directed_;
+    std::vector<int> landmarks_;
+    std::vector<T> from_;  //d(L, v) at v * k + i
+    std::vector<T> to_;    //d(v, L), directed only
+    std::vector<long long> fromScale_;
+    std::vector<long long> toScale_;
+
+    //a - b for stored a and b at scale s, rounded so it never overestimates
+    //a * s <= true a and b * s > true b - s, so (a - b) * s - (s - 1) is safe
+    static long long diff(T a, T b, long long s) {
+        if (a == UNREACHABLE || b == UNREACHABLE) return 0;
+        return (static_cast<long long>(a) - static_cast<long long>(b)) * s - (s - 1);
+    }
+
+    //column i of table from dist, returns the scale used
+    long long fill(std::vector<T>& table, int i, const std::vector<long long>& dist) const {
+        const long long INF = std::numeric_limits<long long>::max() / 4;
+        const long long top = static_cast<long long>(UNREACHABLE) - 1;
+        long long maxDist = 0;
+        for (long long d : dist) {
+            if (d < INF && d > maxDist) maxDist = d;
+        }
+        const long long s = maxDist <= top ? 1 : (maxDist + top - 1) / top;
+        const int k = num_landmarks();
+        for (int v = 0; v < n_; ++v) {
+            if (dist[v] < INF) table[static_cast<size_t>(v) * k + i] = static_cast<T>(dist[v] / s);
+        }
+        return s;
+    }
+
+    template<typename PQ, typename GraphT>
+    static std::vector<int> selectLandmarks(const GraphT& g, int k, LandmarkSelection selection, unsigned seed) {
+        const int n = g.num_vertices();
+        const long long INF = std::numeric_limits<long long>::max() / 4;
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> pick(0, n - 1);
+
+        PQ pq;
+        DijkstraResult res;
+        DijkstraWorkspace<PQ> ws;
+        auto run = [&](int source) {
+            pq.reset();
+            dijkstra_into(g, source, pq, res, ws);
+        };
+
+        std::vector<int> chosen;
+        std::vector<char> isLandmark(n, 0);
+        auto randomFree = [&]() {
+            int v = pick(rng);
+            while (isLandmark[v]) v = pick(rng);
+            return v;
+        };
+
+        if (selection == LANDMARKS_FARTHEST) {
+            //minDist[v] is v's distance from the nearest landmark so far. a
+            //vertex no landmark reaches goes first, it is on its own there
+            std::vector<long long> minDist(n, INF);
+            run(pick(rng));
+            int next = static_cast<int>(std::max_element(res.dist.begin(), res.dist.end(), [&](long long a, long long b) {
+                return (a < INF ? a : -1) < (b < INF ? b : -1);
+            }) - res.dist.begin());
+            while (static_cast<int>(chosen.size()) < k) {
+                chosen.push_back(next);
+                isLandmark[next] = 1;
+                if (static_cast<int>(chosen.size()) == k) break;
+                run(next);
+                next = -1;
+                for (int v = 0; v < n; ++v) {
+                    minDist[v] = std::min(minDist[v], res.dist[v]);
+                    if (isLandmark[v]) continue;
+                    if (next < 0 || (minDist[next] < INF && (minDist[v] == INF || minDist[v] > minDist[next]))) next = v;
+                }
+            }
+            return chosen;
+        }
+
+        //avoid, with d(L, .) of the landmarks picked so far
+        std::vector<std::vector<long long>> fromLandmark;
+        std::vector<long long> weight(n);
+        std::vector<char> covered(n);
+        std::vector<int> childOffsets(n + 1), children(n), order;
+        order.reserve(n);
+        while (static_cast<int>(chosen.size()) < k) {
+            const int root = pick(rng);
+            run(root);
+            const std::vector<long long>& d = res.dist;
+
+            //how far the best landmark bound falls short of d(root, v)
+            for (int v = 0; v < n; ++v) {
+                covered[v] = isLandmark[v];
+                if (d[v] >= INF) {
+                    weight[v] = 0;
+                    continue;
+                }
+                long long lb = 0;
+                for (const std::vector<long long>& dl : fromLandmark) {
+                    if (dl[v] >= INF || dl[root] >= INF) continue;
+                    lb = std::max(lb, dl[v] - dl[root]);
+                    if (!g.directed()) lb = std::max(lb, dl[root] - dl[v]);
+                }
+                weight[v] = d[v] - lb;
+            }
+
+            //shortest path tree as child lists, then top down order from root
+            std::fill(childOffsets.begin(), childOffsets.end(), 0);
+            for (int v = 0; v < n; ++v) {
+                if (res.parent[v] >= 0) childOffsets[res.parent[v] + 1]++;
+            }
+            for (int v = 0; v < n; ++v) childOffsets[v + 1] += childOffsets[v];
+            std::vector<int> fillAt(childOffsets.begin(), childOffsets.end() - 1);
+            for (int v = 0; v < n; ++v) {
+                if (res.parent[v] >= 0) children[fillAt[res.parent[v]]++] = v;
+            }
+            order.clear();
+            order.push_back(root);
+            for (size_t i = 0; i < order.size(); ++i) {
+                for (int c = childOffsets[order[i]]; c < childOffsets[order[i] + 1]; ++c) order.push_back(children[c]);
+            }
+
+            //bottom up, a subtree holding a landmark weighs nothing
+            for (size_t i = order.size(); i-- > 0;) {
+                const int v = order[i];
+                if (covered[v]) weight[v] = 0;
+                const int p = res.parent[v];
+                if (p < 0) continue;
+                if (covered[v]) covered[p] = 1;
+                weight[p] += weight[v];
+            }
+
+            int v = root;
+            while (true) {
+                int best = -1;
+                for (int c = childOffsets[v]; c < childOffsets[v + 1]; ++c) {
+                    const int child = children[c];
+                    if (weight[child] > 0 && (best < 0 || weight[child] > weight[best])) best = child;
+                }
+                if (best < 0) break;
+                v = best;
+            }
+            if (isLandmark[v]) v = randomFree();
+
+            chosen.push_back(v);
+            isLandmark[v] = 1;
+            if (static_cast<int>(chosen.size()) == k) break;
+            run(v);
+            fromLandmark.push_back(res.dist);
+        }
+        return chosen;
+    }
+};
+
+//alt heuristic for astar towards target
+//bounds from every landmark cost k lookups per vertex, so only the active
+//landmarks that bound d(source, target) best are asked; 0 asks all of them
+template<typename T>
+class AltHeuristic {
+public:
+    AltHeuristic(const LandmarkTable<T>& table, int source, int target, int active = 4)
+        : table_(&table), target_(target) {
+        const int k = table.num_landmarks();
+        for (int i = 0; i < k; ++i) active_.push_back(i);
+        if (active > 0 && active < k) {
+            std::partial_sort(active_.begin(), active_.begin() + active, active_.end(), [&](int a, int b) {
+                return table.bound(a, source, target) > table.bound(b, source, target);
+            });
+            active_.resize(active);
+        }
+    }
+
+    long long operator()(int v) const {
+        long long best = 0;
+        for (int i : active_) best = std::max(best, table_->bound(i, v, target_));
+        return best;
+    }
+
+private:
+    const LandmarkTable<T>* table_;
+    int target_;
+    std::vector<int> active_;
+};
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef LINK_CUT_TREE_H
+#define LINK_CUT_TREE_H
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//sleator and tarjan's link cut tree over a forest of weighted nodes
+//each preferred path is a splay tree keyed by depth, so link, cut, find_root
+//and the heaviest node on a path all take O(log n) amortized
+//an edge of the represented forest is meant to be a node of its own between
+//its endpoints, carrying the edge weight, so path_max names an edge
+//arrays instead of node structs, -1 is the null link
+class LinkCutTree {
+public:
+    //lighter than any weight, for nodes that stand for vertices
+    static constexpr long long NO_WEIGHT = std::numeric_limits<long long>::min();
+
+    explicit LinkCutTree(int n = 0) { assign(n); }
+
+    //n single node trees, all NO_WEIGHT
+    void assign(int n) {
+        if (n < 0) throw std::invalid_argument("LinkCutTree: n must be >= 0");
+        left_.assign(n, -1);
+        right_.assign(n, -1);
+        parent_.assign(n, -1);
+        flip_.assign(n, 0);
+        weight_.assign(n, NO_WEIGHT);
+        best_.resize(n);
+        for (int x = 0; x < n; ++x) best_[x] = x;
+    }
+
+    int size() const { return static_cast<int>(parent_.size()); }
+
+    long long weight(int x) const { return weight_[x]; }
+
+    //only for a node that is on its own, i.e. not linked to anything
+    void set_weight(int x, long long w) {
+        weight_[x] = w;
+        best_[x] = x;
+    }
+
+    //bulk load a rooted forest right after assign: with every node still its
+    //own splay tree, a path parent pointer per node is all there is, so
+    //this is O(1) where link would splay. p is x's parent in the forest
+    void set_parent(int x, int p) { parent_[x] = p; }
+
+    //root of x's tree
+    int find_root(int x) {
+        access(x);
+        while (true) {
+            push(x);
+            if (left_[x] < 0) break;
+            x = left_[x];
+        }
+        splay(x);
+        return x;
+    }
+
+    bool connected(int a, int b) { return a == b || find_root(a) == find_root(b); }
+
+    //a and b must be in different trees
+    void link(int a, int b) {
+        make_root(a);
+        parent_[a] = b;
+    }
+
+    //a and b must be adjacent
+    void cut(int a, int b) {
+        make_root(a);
+        access(b);
+        //a is now b's only left descendant
+        left_[b] = -1;
+        parent_[a] = -1;
+        pull(b);
+    }
+
+    //heaviest node on the path a .. b, both included. a and b must be connected
+    int path_max(int a, int b) {
+        make_root(a);
+        access(b);
+        return best_[b];
+    }
+
+private:
+    std::vector<int> left_;
+    std::vector<int> right_;
+    std::vector<int> parent_;     //splay parent, or path parent for a splay root
+    std::vector<char> flip_;      //children still to be swapped below here
+    std::vector<long long> weight_;
+    std::vector<int> best_;       //heaviest node in the splay subtree
+    std::vector<int> pending_;    //splay's path to push flips down
+
+    bool is_splay_root(int x) const {
+        const int p = parent_[x];
+        return p < 0 || (left_[p] != x && right_[p] != x);
+    }
+
+    void pull(int x) {
+        int b = x;
+        if (left_[x] >= 0 && weight_[best_[left_[x]]] > weight_[b]) b = best_[left_[x]];
+        if (right_[x] >= 0 && weight_[best_[right_[x]]] > weight_[b]) b = best_[right_[x]];
+        best_[x] = b;
+    }
+
+    void push(int x) {
+        if (!flip_[x]) return;
+        std::swap(left_[x], right_[x]);
+        if (left_[x] >= 0) flip_[left_[x]] ^= 1;
+        if (right_[x] >= 0) flip_[right_[x]] ^= 1;
+        flip_[x] = 0;
+    }
+
+    void rotate(int x) {
+        const int p = parent_[x];
+        const int g = parent_[p];
+        if (!is_splay_root(p)) {
+            if (left_[g] == p) left_[g] = x;
+            else right_[g] = x;
+        }
+        parent_[x] = g;
+        if (left_[p] == x) {
+            left_[p] = right_[x];
+            if (left_[p] >= 0) parent_[left_[p]] = p;
+            right_[x] = p;
+        } else {
+            right_[p] = left_[x];
+            if (right_[p] >= 0) parent_[right_[p]] = p;
+            left_[x] = p;
+        }
+        parent_[p] = x;
+        pull(p);
+        pull(x);
+    }
+
+    void splay(int x) {
+        //flips are pushed top down before any rotation looks at the children
+        pending_.clear();
+        for (int y = x;; y = parent_[y]) {
+            pending_.push_back(y);
+            if (is_splay_root(y)) break;
+        }
+        for (size_t i = pending_.size(); i-- > 0;) push(pending_[i]);
+
+        while (!is_splay_root(x)) {
+            const int p = parent_[x];
+            if (!is_splay_root(p)) {
+                const int g = parent_[p];
+                rotate((left_[g] == p) == (left_[p] == x) ? p : x);
+            }
+            rotate(x);
+        }
+    }
+
+    //makes root .. x the preferred path, x ends up the root of its splay tree
+    //with nothing deeper on its right
+    void access(int x) {
+        int last = -1;
+        for (int y = x; y >= 0; y = parent_[y]) {
+            splay(y);
+            right_[y] = last;
+            pull(y);
+            last = y;
+        }
+        splay(x);
+    }
+
+    void make_root(int x) {
+        access(x);
+        flip_[x] ^= 1;
+    }
+};
+
+#endif
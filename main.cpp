@@ -2,11 +2,15 @@
 #include <vector>
 
 #include "graph.h"
+#include "csrGraph.h"
 #include "dijkstra.h"
+#include "deltaStepping.h"
 #include "prim.h"
+#include "boruvka.h"
 
 #include "fibonacciHeap.h"
 #include "pairingHeap.h"
+#include "daryHeap.h"
 
 // Helper: print Dijkstra distances
 static void print_dists(const std::vector<long long>& dist) {
@@ -61,6 +65,35 @@ int main() {
             auto res = dijkstra(g, 0, pq);
             print_dists(res.dist);
         }
+
+        {
+            std::cout << "\n-- Using DaryHeap (d=4) --\n";
+            DaryHeap<long long, int, 4> pq;
+            auto res = dijkstra(g, 0, pq);
+            print_dists(res.dist);
+        }
+
+        {
+            std::cout << "\n-- Using PairingHeap, lazy insertion --\n";
+            PairingHeap<long long, int> pq;
+            auto res = dijkstra(g, 0, pq, true);
+            print_dists(res.dist);
+            std::cout << "heap inserts = " << pq.insertCount << "\n";
+        }
+
+        {
+            std::cout << "\n-- Using delta stepping (delta=3, 2 threads) --\n";
+            auto res = delta_stepping(g, 0, 3, 2);
+            print_dists(res.dist);
+        }
+
+        {
+            std::cout << "\n-- Using FibonacciHeap on CSRGraph --\n";
+            CSRGraph csr(g);
+            FibonacciHeap<long long, int> pq;
+            auto res = dijkstra(csr, 0, pq);
+            print_dists(res.dist);
+        }
     }
 
     // -------------------------
@@ -98,6 +131,30 @@ int main() {
             std::cout << "MST total weight = " << res.total_weight << "\n";
             std::cout << "connected = " << (res.connected ? "true" : "false") << "\n";
         }
+
+        {
+            std::cout << "\n-- Using DaryHeap (d=8) --\n";
+            DaryHeap<long long, int, 8> pq;
+            auto res = prim_mst(g, 0, pq);
+            std::cout << "MST total weight = " << res.total_weight << "\n";
+            std::cout << "connected = " << (res.connected ? "true" : "false") << "\n";
+        }
+
+        {
+            std::cout << "\n-- Using parallel Boruvka (2 threads) --\n";
+            auto res = boruvka_mst(g, 0, 2);
+            std::cout << "MST total weight = " << res.total_weight << "\n";
+            std::cout << "connected = " << (res.connected ? "true" : "false") << "\n";
+        }
+
+        {
+            std::cout << "\n-- Using PairingHeap on CSRGraph built from edge list --\n";
+            CSRGraph csr(6, false, {{0, 1, 4}, {0, 2, 3}, {1, 2, 1}, {1, 3, 2}, {2, 3, 4}, {3, 4, 2}, {4, 5, 6}});
+            PairingHeap<long long, int> pq;
+            auto res = prim_mst(csr, 0, pq);
+            std::cout << "MST total weight = " << res.total_weight << "\n";
+            std::cout << "connected = " << (res.connected ? "true" : "false") << "\n";
+        }
     }
 
     std::cout << "\nAll tests finished.\n";
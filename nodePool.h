@@ -0,0 +1,111 @@
+//slab allocator behind the pointer based heaps
+
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//hands out nodes from big slabs instead of one new per node
+//released nodes go on a free list and get reused first
+//reset() rewinds to the first slab but keeps every slab allocated,
+//so back to back queries stop hitting the system allocator
+//with pooled = false every acquire is a plain new and every release a delete,
+//which is the old behavior and is kept around for benchmarking
+template<typename T>
+class NodePool {
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static constexpr size_t FIRST_SLAB = 64;
+    static constexpr size_t MAX_SLAB = 1 << 16;
+
+    bool pooled_;
+    std::vector<Slot*> slabs_;
+    std::vector<size_t> slabSizes_;
+    size_t slab_;      //slab currently being carved
+    size_t used_;      //slots used in that slab
+    Slot* freeList_;
+    long long allocations_;
+
+    Slot* carve() {
+        while (slab_ < slabs_.size() && used_ == slabSizes_[slab_]) {
+            slab_++;
+            used_ = 0;
+        }
+        if (slab_ == slabs_.size()) {
+            size_t size = slabs_.empty() ? FIRST_SLAB : slabSizes_.back() * 2;
+            if (size > MAX_SLAB) size = MAX_SLAB;
+            slabs_.push_back(new Slot[size]);
+            slabSizes_.push_back(size);
+            allocations_++;
+            used_ = 0;
+        }
+        return &slabs_[slab_][used_++];
+    }
+
+public:
+    explicit NodePool(bool pooled = true)
+        : pooled_(pooled), slab_(0), used_(0), freeList_(nullptr), allocations_(0) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() {
+        for (Slot* s : slabs_) delete[] s;
+    }
+
+    template<typename... Args>
+    T* acquire(Args&&... args) {
+        if (!pooled_) {
+            allocations_++;
+            return new T(std::forward<Args>(args)...);
+        }
+
+        Slot* s = freeList_;
+        if (s != nullptr) {
+            freeList_ = s->next;
+        } else {
+            s = carve();
+        }
+        return new (s->storage) T(std::forward<Args>(args)...);
+    }
+
+    void release(T* node) {
+        if (!pooled_) {
+            delete node;
+            return;
+        }
+
+        node->~T();
+        Slot* s = reinterpret_cast<Slot*>(node);
+        s->next = freeList_;
+        freeList_ = s;
+    }
+
+    //forget every node handed out and start carving from the first slab again
+    //nodes that still need a destructor must be released before this
+    void reset() {
+        slab_ = 0;
+        used_ = 0;
+        freeList_ = nullptr;
+    }
+
+    //true when live nodes can be dropped by reset() without visiting them
+    bool skipRelease() const {
+        return pooled_ && std::is_trivially_destructible<T>::value;
+    }
+
+    bool pooled() const { return pooled_; }
+
+    //number of times the system allocator was called
+    long long allocations() const { return allocations_; }
+};
+
+#endif
@@ -4,6 +4,7 @@
 #define PAIRING_HEAP_H
 
 #include "priorityQueue.h"
+#include "nodePool.h"
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -21,11 +22,36 @@ struct PairNode : public Node<K, V> {
     }
 };
 
-template <typename K, typename V>
-class PairingHeap : public PriorityQueue<K, V> {
+//how extract_min combines the old root's children
+//  PAIRING_TWO_PASS      pair left to right, then meld right to left (classic)
+//  PAIRING_MULTIPASS     keep pairing front to back until one tree is left
+//  PAIRING_AUX_TWO_PASS  two pass, but inserts and decreased nodes wait in an
+//                        auxiliary list that is multipass merged into the
+//                        main tree only when extract_min needs it
+//                        (stasko and vitter)
+enum PairingMode {
+    PAIRING_TWO_PASS,
+    PAIRING_MULTIPASS,
+    PAIRING_AUX_TWO_PASS
+};
+
+//structure stat (PQ_INSTRUMENT builds): subtrees left after the first
+//pairing pass of each extract_min
+template <typename K, typename V, PairingMode M = PAIRING_TWO_PASS>
+class PairingHeap final : public PriorityQueue<K, V> {
 private:
     PairNode<K, V>* root_;
     int nodeCount_;
+    NodePool<PairNode<K, V>> pool_;
+
+    //auxiliary list for PAIRING_AUX_TWO_PASS, linked like a child list with
+    //the head's prev null, and its smallest node
+    PairNode<K, V>* aux_;
+    PairNode<K, V>* auxMin_;
+
+    //scratch for the merge passes, kept so extract_min stops allocating once
+    //it has grown to the longest child list seen
+    std::vector<PairNode<K, V>*> merged_;
 
     //combines two heaps, smaller root becomes parent
     static PairNode<K, V>* meld(PairNode<K, V>* a, PairNode<K, V>* b) {
@@ -74,10 +100,11 @@ private:
     //two pass pairing used after extract_min
     //pass 1: meld pairs left to right
     //pass 2: meld results right to left
-    static PairNode<K, V>* twoPassMerge(PairNode<K, V>* firstSibling) {
+    PairNode<K, V>* twoPassMerge(PairNode<K, V>* firstSibling) {
         if (!firstSibling) return nullptr;
 
-        std::vector<PairNode<K, V>*> merged;
+        std::vector<PairNode<K, V>*>& merged = merged_;
+        merged.clear();
         PairNode<K, V>* cur = firstSibling;
 
         while (cur) {
@@ -99,6 +126,8 @@ private:
             cur = nextPair;
         }
 
+        this->recordStructure(static_cast<long long>(merged.size()));
+
         PairNode<K, V>* res = nullptr;
         for (int i = static_cast<int>(merged.size()) - 1; i >= 0; --i) {
             res = meld(res, merged[i]);
@@ -106,46 +135,126 @@ private:
         return res;
     }
 
-    //recursively delete all nodes
-    static void deleteAll(PairNode<K, V>* n) {
-        if (!n) return;
-        PairNode<K, V>* c = n->child;
-        while (c) {
-            PairNode<K, V>* next = c->next;
-            deleteAll(c);
-            c = next;
+    void pushAux(PairNode<K, V>* n) {
+        n->prev = nullptr;
+        n->next = aux_;
+        if (aux_) aux_->prev = n;
+        aux_ = n;
+        if (!auxMin_ || n->key < auxMin_->key) auxMin_ = n;
+    }
+
+    //multipass pairing, trees are melded in pairs front to back and each
+    //result goes to the back of the queue until only one is left
+    PairNode<K, V>* multipassMerge(PairNode<K, V>* firstSibling) {
+        if (!firstSibling) return nullptr;
+
+        std::vector<PairNode<K, V>*>& queue = merged_;
+        queue.clear();
+        for (PairNode<K, V>* cur = firstSibling; cur;) {
+            PairNode<K, V>* next = cur->next;
+            cur->prev = nullptr;
+            cur->next = nullptr;
+            queue.push_back(cur);
+            cur = next;
+        }
+
+        this->recordStructure(static_cast<long long>((queue.size() + 1) / 2));
+
+        size_t head = 0;
+        while (queue.size() - head > 1) {
+            PairNode<K, V>* a = queue[head++];
+            PairNode<K, V>* b = queue[head++];
+            queue.push_back(meld(a, b));
+        }
+        return queue[head];
+    }
+
+    PairNode<K, V>* combine(PairNode<K, V>* firstSibling) {
+        if (M == PAIRING_MULTIPASS) return multipassMerge(firstSibling);
+        return twoPassMerge(firstSibling);
+    }
+
+    //delete all nodes without recursion, each node's child list is spliced
+    //in right after it before it is released, so the walk stays a flat list
+    //(a recursive walk overflows the stack on the deep trees worst case
+    //inputs build)
+    void deleteAll(PairNode<K, V>* n) {
+        while (n) {
+            if (n->child) {
+                PairNode<K, V>* last = n->child;
+                while (last->next) last = last->next;
+                last->next = n->next;
+                n->next = n->child;
+            }
+            PairNode<K, V>* next = n->next;
+            pool_.release(n);
+            n = next;
         }
-        delete n;
     }
 
 public:
-    PairingHeap() : root_(nullptr), nodeCount_(0) {}
+    //pooled = false allocates every node with new like before
+    explicit PairingHeap(bool pooled = true)
+        : root_(nullptr), nodeCount_(0), pool_(pooled), aux_(nullptr), auxMin_(nullptr) {}
 
     ~PairingHeap() override {
-        deleteAll(root_);
+        if (!pool_.skipRelease()) {
+            deleteAll(root_);
+            deleteAll(aux_);
+        }
         root_ = nullptr;
+        aux_ = nullptr;
         nodeCount_ = 0;
     }
 
+    void reset() override {
+        if (!pool_.skipRelease()) {
+            deleteAll(root_);
+            deleteAll(aux_);
+        }
+        pool_.reset();
+        root_ = nullptr;
+        aux_ = nullptr;
+        auxMin_ = nullptr;
+        nodeCount_ = 0;
+        this->resetCounters();
+    }
+
+    //times the system allocator was called for nodes
+    long long allocations() const { return pool_.allocations(); }
+
     bool is_empty() override {
-        return root_ == nullptr;
+        return root_ == nullptr && aux_ == nullptr;
     }
 
     Node<K, V>* insert(K key, V value) override {
         this->insertCount++;
-        PairNode<K, V>* n = new PairNode<K, V>(key, value);
-        root_ = meld(root_, n);
+        OpTimer timer(this->insertHistogram());
+        PairNode<K, V>* n = pool_.acquire(key, value);
+        if (M == PAIRING_AUX_TWO_PASS) {
+            pushAux(n);
+        } else {
+            root_ = meld(root_, n);
+        }
         nodeCount_++;
         return n;
     }
 
     std::pair<K, V> find_min() override {
-        if (!root_) throw std::runtime_error("Heap is empty");
-        return {root_->key, root_->value};
+        PairNode<K, V>* top = root_;
+        if (auxMin_ && (!top || auxMin_->key < top->key)) top = auxMin_;
+        if (!top) throw std::runtime_error("Heap is empty");
+        return {top->key, top->value};
     }
 
     std::pair<K, V> extract_min() override {
         this->extractCount++;
+        OpTimer timer(this->extractHistogram());
+        if (aux_) {
+            root_ = meld(root_, multipassMerge(aux_));
+            aux_ = nullptr;
+            auxMin_ = nullptr;
+        }
         if (!root_) throw std::runtime_error("Heap is empty");
 
         PairNode<K, V>* oldRoot = root_;
@@ -159,25 +268,33 @@ public:
         //detach old root so delete doesnt follow children
         oldRoot->child = nullptr;
 
-        root_ = twoPassMerge(children);
+        root_ = combine(children);
 
-        delete oldRoot;
+        pool_.release(oldRoot);
         nodeCount_--;
         return result;
     }
 
     void decrease_key(Node<K, V>* node, K new_key) override {
         this->decreaseKeyCount++;
+        OpTimer timer(this->decreaseKeyHistogram());
         PairNode<K, V>* x = static_cast<PairNode<K, V>*>(node);
         if (!x) throw std::runtime_error("Null node handle");
         if (new_key > x->key) throw std::runtime_error("New key is greater than current key");
 
         x->key = new_key;
 
-        //if not root, cut and meld back in
+        //if not root, cut and meld back in (or park it in the aux list)
         if (x != root_ && x->prev) {
             cutFromParentOrSibling(x);
-            root_ = meld(root_, x);
+            if (M == PAIRING_AUX_TWO_PASS) {
+                pushAux(x);
+            } else {
+                root_ = meld(root_, x);
+            }
+        } else if (M == PAIRING_AUX_TWO_PASS && x != root_ && x->key < auxMin_->key) {
+            //head of the aux list
+            auxMin_ = x;
         }
     }
 };
@@ -0,0 +1,250 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "priorityQueue.h"
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//hardware counters read through linux perf_event_open
+//every event is opened on its own, so a machine (or vm, or container with a
+//high perf_event_paranoid) that only has some of them still reports those.
+//anything that could not be opened reads as missing, never as zero
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,   //last level cache
+    PERF_L1D_MISSES,     //l1 data cache read misses
+    PERF_DTLB_MISSES,    //data tlb read misses
+    PERF_BRANCH_MISSES,
+    PERF_PAGE_FAULTS,    //software event, works even without a pmu
+    PERF_EVENT_COUNT
+};
+
+inline const char* perfEventName(int e) {
+    static const char* names[PERF_EVENT_COUNT] = {
+        "cycles", "instructions", "cache_misses", "l1d_misses", "dtlb_misses", "branch_misses", "page_faults"};
+    return names[e];
+}
+
+struct PerfSample {
+    long long value[PERF_EVENT_COUNT];
+    bool valid[PERF_EVENT_COUNT];
+
+    PerfSample() {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            value[e] = 0;
+            valid[e] = false;
+        }
+    }
+
+    bool has(PerfEvent e) const { return valid[e]; }
+
+    //instructions per cycle, 0 when either counter is missing
+    double ipc() const {
+        if (!valid[PERF_CYCLES] || !valid[PERF_INSTRUCTIONS] || value[PERF_CYCLES] == 0) return 0;
+        return static_cast<double>(value[PERF_INSTRUCTIONS]) / value[PERF_CYCLES];
+    }
+
+    PerfSample& operator+=(const PerfSample& other) {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            value[e] += other.value[e];
+            valid[e] = valid[e] || other.valid[e];
+        }
+        return *this;
+    }
+};
+
+//one set of counters for the calling thread, user space only
+//start() zeroes and enables, stop() disables and reads. resume() and pause()
+//enable and disable without zeroing, for adding up many short sections
+//counts are scaled up if the kernel had to multiplex the pmu
+class PerfCounters {
+public:
+    PerfCounters() {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) fd_[e] = open(static_cast<PerfEvent>(e));
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (fd_[e] >= 0) ::close(fd_[e]);
+        }
+#endif
+    }
+
+    //true if at least one hardware event opened
+    bool available() const {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (e != PERF_PAGE_FAULTS && fd_[e] >= 0) return true;
+        }
+        return false;
+    }
+
+    bool has(PerfEvent e) const { return fd_[e] >= 0; }
+
+    void start() {
+        control(CTL_RESET);
+        control(CTL_ENABLE);
+    }
+
+    PerfSample stop() {
+        control(CTL_DISABLE);
+        return read();
+    }
+
+    void resume() { control(CTL_ENABLE); }
+    void pause() { control(CTL_DISABLE); }
+
+    //counts since the last start(), without stopping
+    PerfSample read() const {
+        PerfSample s;
+#ifdef __linux__
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (fd_[e] < 0) continue;
+            uint64_t buf[3];  //value, time enabled, time running
+            if (::read(fd_[e], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) continue;
+            double v = static_cast<double>(buf[0]);
+            if (buf[2] > 0 && buf[2] < buf[1]) v *= static_cast<double>(buf[1]) / buf[2];
+            s.value[e] = static_cast<long long>(v);
+            s.valid[e] = true;
+        }
+#endif
+        return s;
+    }
+
+private:
+    enum Control { CTL_RESET, CTL_ENABLE, CTL_DISABLE };
+
+    int fd_[PERF_EVENT_COUNT];
+
+#ifdef __linux__
+    static int open(PerfEvent e) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        const uint64_t cacheRead = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        switch (e) {
+            case PERF_CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PERF_INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PERF_CACHE_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case PERF_L1D_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | cacheRead;
+                break;
+            case PERF_DTLB_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_DTLB | cacheRead;
+                break;
+            case PERF_BRANCH_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            default:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+                break;
+        }
+
+        //this thread, any cpu, no group
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    void control(Control c) {
+        const unsigned long request = c == CTL_RESET ? PERF_EVENT_IOC_RESET
+                                    : c == CTL_ENABLE ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE;
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (fd_[e] >= 0) ::ioctl(fd_[e], request, 0);
+        }
+    }
+#else
+    static int open(PerfEvent) { return -1; }
+    void control(Control) {}
+#endif
+};
+
+//heap wrapper that splits counters by heap phase
+//extract_min counts as "extract", insert and decrease_key as "update"
+//each call switches counters on and off with an ioctl, which is far too slow
+//to time anything but is not counted itself since kernel work is excluded.
+//the few user space instructions around each syscall still land in the
+//counts, so compare heaps against each other rather than reading the
+//numbers as absolute
+template<typename PQ>
+class PerfPhaseHeap final {
+public:
+    using Handle = pq_handle_t<PQ, long long, int>;
+
+    explicit PerfPhaseHeap(PQ& inner) : inner_(inner) {
+        extract_.start();
+        extract_.pause();
+        update_.start();
+        update_.pause();
+    }
+
+    Handle insert(long long key, int value) {
+        update_.resume();
+        Handle h = inner_.insert(key, value);
+        update_.pause();
+        return h;
+    }
+
+    void decrease_key(Handle h, long long key) {
+        update_.resume();
+        inner_.decrease_key(h, key);
+        update_.pause();
+    }
+
+    std::pair<long long, int> extract_min() {
+        extract_.resume();
+        auto top = inner_.extract_min();
+        extract_.pause();
+        return top;
+    }
+
+    bool is_empty() { return inner_.is_empty(); }
+
+    void reset() {
+        inner_.reset();
+        extract_.start();
+        extract_.pause();
+        update_.start();
+        update_.pause();
+    }
+
+    PerfSample extractCounters() const { return extract_.read(); }
+    PerfSample updateCounters() const { return update_.read(); }
+    bool available() const { return extract_.available(); }
+
+private:
+    PQ& inner_;
+    PerfCounters extract_;
+    PerfCounters update_;
+};
+
+#endif
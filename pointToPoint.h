@@ -0,0 +1,193 @@
+#ifndef POINT_TO_POINT_H
+#define POINT_TO_POINT_H
+
+#include "csrGraph.h"
+#include "priorityQueue.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+//answer to a single source, single target query
+struct PathResult {
+    bool found = false;
+    long long dist = 0;     //only meaningful when found
+    std::vector<int> path;  //source first, target last, empty if not found
+    long long settled = 0;  //vertices taken out of the heaps, both sides counted
+};
+
+//state of one search direction, sized once and then cleared through the list
+//of touched vertices, so a query that stays local also costs local time
+//to clear instead of O(n)
+template<typename PQ>
+struct SearchSpace {
+    using Handle = pq_handle_t<PQ, long long, int>;
+
+    static constexpr long long INF = std::numeric_limits<long long>::max() / 4;
+
+    std::vector<long long> dist;
+    std::vector<int> parent;    //-1 for the root and for untouched vertices
+    std::vector<Handle> handle; //null unless the vertex is in the heap
+    std::vector<char> settled;
+    std::vector<int> touched;
+
+    //get ready for a search on n vertices
+    void prepare(int n) {
+        if (static_cast<int>(dist.size()) != n) {
+            dist.assign(n, INF);
+            parent.assign(n, -1);
+            handle.assign(n, nullptr);
+            settled.assign(n, 0);
+            touched.clear();
+            return;
+        }
+        for (int v : touched) {
+            dist[v] = INF;
+            parent[v] = -1;
+            handle[v] = nullptr;
+            settled[v] = 0;
+        }
+        touched.clear();
+    }
+
+    bool reached(int v) const { return dist[v] < INF; }
+
+    //puts v in the heap at d, or lowers it there, if d beats what v has
+    //true if it did
+    bool relax(PQ& pq, int v, long long d, int from) {
+        return relax(pq, v, d, d, from);
+    }
+
+    //same but the heap key is key instead of d, for goal directed searches
+    //that order by distance plus an estimate of what is left
+    //key has to shrink whenever d does, which it does for a fixed estimate
+    bool relax(PQ& pq, int v, long long d, long long key, int from) {
+        if (d >= dist[v]) return false;
+        if (dist[v] == INF) touched.push_back(v);
+        dist[v] = d;
+        parent[v] = from;
+        if (handle[v] == nullptr) {
+            handle[v] = pq.insert(key, v);
+        } else {
+            pq.decrease_key(handle[v], key);
+        }
+        return true;
+    }
+
+    //takes the closest vertex out of the heap and marks it settled
+    int settle(PQ& pq) {
+        int u = pq.extract_min().second;
+        handle[u] = nullptr;
+        settled[u] = 1;
+        return u;
+    }
+};
+
+//both directions of a bidirectional search, kept between queries
+template<typename PQ>
+struct BidirectionalWorkspace {
+    SearchSpace<PQ> forward;
+    SearchSpace<PQ> backward;
+};
+
+//every edge turned around, as a csr graph
+//for a directed graph this is what the backward search walks. an undirected
+//graph is its own reverse, so pass it twice instead of building this
+template<typename GraphT>
+inline CSRGraph reverseGraph(const GraphT& g) {
+    const int n = g.num_vertices();
+    std::vector<CSRGraph::InputEdge> edges;
+    for (int u = 0; u < n; ++u) {
+        for (const auto& e : g.neighbors(u)) edges.push_back({e.to, u, e.weight});
+    }
+    return CSRGraph(n, true, edges);
+}
+
+//shortest source -> target path by searching forward from source on g and
+//backward from target on rev at the same time
+//each step advances the side whose heap has the smaller key, and every edge
+//that reaches a vertex the other side has seen offers a path of length
+//mu. the search stops once the two heap minimums add up to mu or more, at
+//which point no path through an unsettled vertex can be shorter
+//rev must be reverseGraph(g) for a directed g, or g itself if undirected
+//both heaps are reset first and left holding whatever was not settled
+template<typename GraphT, typename RevT, typename PQ>
+inline void bidirectional_dijkstra_into(const GraphT& g, const RevT& rev, int source, int target,
+                                        PQ& fwd, PQ& bwd, PathResult& res, BidirectionalWorkspace<PQ>& ws) {
+    static_assert(is_priority_queue<PQ, long long, int>::value,
+                  "bidirectional_dijkstra: PQ must provide the PriorityQueue operations");
+
+    const int n = g.num_vertices();
+    if (rev.num_vertices() != n) throw std::invalid_argument("bidirectional_dijkstra: reverse graph size differs");
+    if (source < 0 || source >= n || target < 0 || target >= n) {
+        throw std::out_of_range("bidirectional_dijkstra: vertex out of range");
+    }
+
+    const long long INF = SearchSpace<PQ>::INF;
+    SearchSpace<PQ>& f = ws.forward;
+    SearchSpace<PQ>& b = ws.backward;
+    f.prepare(n);
+    b.prepare(n);
+    fwd.reset();
+    bwd.reset();
+
+    res.found = false;
+    res.dist = 0;
+    res.path.clear();
+    res.settled = 0;
+
+    f.relax(fwd, source, 0, -1);
+    b.relax(bwd, target, 0, -1);
+
+    long long mu = source == target ? 0 : INF;
+    int meet = source == target ? source : -1;
+
+    //one step of one side, sp/pq/graph are that side, other is the opposite
+    auto step = [&](SearchSpace<PQ>& sp, SearchSpace<PQ>& other, PQ& pq, const auto& graph) {
+        int u = sp.settle(pq);
+        res.settled++;
+        const long long du = sp.dist[u];
+        for (const auto& e : graph.neighbors(u)) {
+            const int v = e.to;
+            const long long nd = du + static_cast<long long>(e.weight);
+            if (sp.settled[v]) continue;
+            sp.relax(pq, v, nd, u);
+            if (other.reached(v) && sp.dist[v] + other.dist[v] < mu) {
+                mu = sp.dist[v] + other.dist[v];
+                meet = v;
+            }
+        }
+    };
+
+    while (!fwd.is_empty() && !bwd.is_empty()) {
+        const long long topF = fwd.find_min().first;
+        const long long topB = bwd.find_min().first;
+        if (topF + topB >= mu) break;
+        if (topF <= topB) {
+            step(f, b, fwd, g);
+        } else {
+            step(b, f, bwd, rev);
+        }
+    }
+
+    if (meet < 0) return;
+
+    res.found = true;
+    res.dist = mu;
+    for (int v = meet; v != -1; v = f.parent[v]) res.path.push_back(v);
+    std::reverse(res.path.begin(), res.path.end());
+    for (int v = b.parent[meet]; v != -1; v = b.parent[v]) res.path.push_back(v);
+}
+
+//same thing with a fresh workspace and result
+template<typename GraphT, typename RevT, typename PQ>
+inline PathResult bidirectional_dijkstra(const GraphT& g, const RevT& rev, int source, int target,
+                                         PQ& fwd, PQ& bwd) {
+    PathResult res;
+    BidirectionalWorkspace<PQ> ws;
+    bidirectional_dijkstra_into(g, rev, source, target, fwd, bwd, res, ws);
+    return res;
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include "priorityQueue.h"
 
 #include <vector>
+#include <unordered_map>
 #include <limits>
 #include <stdexcept>
 #include <utility>
@@ -18,7 +19,15 @@ struct PrimResult {
 
 //minimum spanning tree using prim's algorithm
 //returns spanning forest if graph is disconnected
-inline PrimResult prim_mst(const Graph& g, int start, PriorityQueue<long long, int>& pq) {
+//GraphT is Graph or CSRGraph, anything with num_vertices(), directed() and neighbors(u)
+//PQ is PriorityQueue<long long, int> for runtime heap selection or a concrete
+//final heap type, in which case the heap calls are not virtual
+//lazyInsert only puts a vertex in the heap once an edge reaches it
+template<typename GraphT, typename PQ>
+inline PrimResult prim_mst(const GraphT& g, int start, PQ& pq, bool lazyInsert = false) {
+    static_assert(is_priority_queue<PQ, long long, int>::value,
+                  "prim_mst: PQ must provide the PriorityQueue operations");
+
     const int n = g.num_vertices();
     if (start < 0 || start >= n) throw std::out_of_range("prim_mst: start out of range");
     if (g.directed()) throw std::invalid_argument("prim_mst: Prim requires an undirected graph");
@@ -30,14 +39,23 @@ inline PrimResult prim_mst(const Graph& g, int start, PriorityQueue<long long, i
     res.key.assign(n, INF);
 
     std::vector<bool> inMST(n, false);
-    std::vector<Node<long long, int>*> handle(n, nullptr);
 
-    //insert all vertices with INF then decrease start to 0
-    for (int v = 0; v < n; ++v) {
-        handle[v] = pq.insert(INF, v);
-    }
+    //eager mode keeps a handle per vertex, lazy mode only the ones still in the heap
+    using Handle = pq_handle_t<PQ, long long, int>;
+    std::vector<Handle> handle;
+    std::unordered_map<int, Handle> frontier;
+
     res.key[start] = 0;
-    pq.decrease_key(handle[start], 0);
+    if (lazyInsert) {
+        frontier.emplace(start, pq.insert(0, start));
+    } else {
+        //insert all vertices with INF then decrease start to 0
+        handle.assign(n, nullptr);
+        for (int v = 0; v < n; ++v) {
+            handle[v] = pq.insert(INF, v);
+        }
+        pq.decrease_key(handle[start], 0);
+    }
 
     long long total = 0;
     int picked = 0;
@@ -50,6 +68,8 @@ inline PrimResult prim_mst(const Graph& g, int start, PriorityQueue<long long, i
             break;
         }
 
+        if (lazyInsert) frontier.erase(u);
+
         if (inMST[u]) {
             continue;
         }
@@ -65,7 +85,16 @@ inline PrimResult prim_mst(const Graph& g, int start, PriorityQueue<long long, i
             if (!inMST[v] && w < res.key[v]) {
                 res.key[v] = w;
                 res.parent[v] = u;
-                pq.decrease_key(handle[v], w);
+                if (!lazyInsert) {
+                    pq.decrease_key(handle[v], w);
+                } else {
+                    auto it = frontier.find(v);
+                    if (it == frontier.end()) {
+                        frontier.emplace(v, pq.insert(w, v));
+                    } else {
+                        pq.decrease_key(it->second, w);
+                    }
+                }
             }
         }
     }
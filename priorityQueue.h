@@ -2,7 +2,10 @@
 #ifndef PRIORITY_QUEUE_H
 #define PRIORITY_QUEUE_H
 
+#include "heapStats.h"
+
 #include <utility>
+#include <type_traits>
 
 using namespace std;
 
@@ -16,9 +19,9 @@ template<typename K, typename V>
 class PriorityQueue {
 public:
 
-    int insertCount = 0;
-    int extractCount = 0;
-    int decreaseKeyCount = 0;
+    long long insertCount = 0;
+    long long extractCount = 0;
+    long long decreaseKeyCount = 0;
 
     virtual Node<K,V>* insert(K key, V value) = 0;
     
@@ -29,8 +32,75 @@ public:
     virtual void decrease_key(Node<K,V>* node, K new_key) = 0;
     
     virtual bool is_empty() = 0;
-    
+
+    //empty the queue for another run, keeps any memory the heap has pooled
+    //handles from before the reset are invalid afterwards
+    virtual void reset() = 0;
+
     virtual ~PriorityQueue() {}
+
+    //latency histograms and structure metric, null unless built with PQ_INSTRUMENT
+    const HeapStats* stats() const {
+#ifdef PQ_INSTRUMENT
+        return &stats_;
+#else
+        return nullptr;
+#endif
+    }
+
+protected:
+    void resetCounters() {
+        insertCount = 0;
+        extractCount = 0;
+        decreaseKeyCount = 0;
+#ifdef PQ_INSTRUMENT
+        stats_.reset();
+#endif
+    }
+
+    //histograms for OpTimer, null when not instrumented
+    LatencyHistogram* insertHistogram() { return histogram(&HeapStats::insert); }
+    LatencyHistogram* extractHistogram() { return histogram(&HeapStats::extract); }
+    LatencyHistogram* decreaseKeyHistogram() { return histogram(&HeapStats::decreaseKey); }
+
+    void recordStructure(long long v) {
+#ifdef PQ_INSTRUMENT
+        stats_.structure.record(v);
+#else
+        (void)v;
+#endif
+    }
+
+private:
+#ifdef PQ_INSTRUMENT
+    HeapStats stats_;
+#endif
+
+    LatencyHistogram* histogram(LatencyHistogram HeapStats::*which) {
+#ifdef PQ_INSTRUMENT
+        return &(stats_.*which);
+#else
+        (void)which;
+        return nullptr;
+#endif
+    }
 };
 
+//compile time check for the algorithm templates
+//true for PriorityQueue itself (virtual calls) and for any concrete heap with
+//the same operations, which the algorithms then call directly so they inline
+template<typename PQ, typename K, typename V, typename = void>
+struct is_priority_queue : std::false_type {};
+
+template<typename PQ, typename K, typename V>
+struct is_priority_queue<PQ, K, V, std::void_t<
+    decltype(std::declval<PQ&>().decrease_key(std::declval<PQ&>().insert(std::declval<K>(), std::declval<V>()), std::declval<K>())),
+    decltype(std::declval<PQ&>().extract_min()),
+    decltype(std::declval<PQ&>().is_empty()),
+    decltype(std::declval<PQ&>().reset())>> : std::true_type {};
+
+//handle type insert() gives back for a heap type
+template<typename PQ, typename K, typename V>
+using pq_handle_t = decltype(std::declval<PQ&>().insert(std::declval<K>(), std::declval<V>()));
+
 #endif
\ No newline at end of file
@@ -0,0 +1,195 @@
+//interfaces to priorityQueue.h
+
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include "priorityQueue.h"
+#include "nodePool.h"
+#include <stdexcept>
+#include <utility>
+
+template<typename V>
+struct RadixNode : public Node<long long, V> {
+    int bucket;
+    RadixNode* prev;
+    RadixNode* next;
+
+    RadixNode(long long k, V v) : bucket(-1), prev(nullptr), next(nullptr) {
+        this->key = k;
+        this->value = v;
+    }
+};
+
+//monotone radix heap for non-negative integer keys
+//bucket b holds keys whose highest bit differing from last_ (the last
+//extracted key) is bit b-1, bucket 0 holds keys equal to last_
+//a key only ever moves to lower buckets, so every operation is O(1)
+//amortized plus O(log C) per extract
+//only valid while no key goes below the last extracted one, which holds for
+//dijkstra with non-negative weights but not for prim, inserts and
+//decrease_keys that break this throw logic_error
+//structure stat (PQ_INSTRUMENT builds): nodes redistributed by each refill
+template<typename V>
+class RadixHeap final : public PriorityQueue<long long, V> {
+private:
+    static constexpr int BUCKETS = 65;
+
+    RadixNode<V>* buckets_[BUCKETS];
+    long long last_;
+    int nodeCount_;
+    NodePool<RadixNode<V>> pool_;
+
+    int bucketFor(long long key) const {
+        unsigned long long diff = static_cast<unsigned long long>(key ^ last_);
+        return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+    }
+
+    void push(RadixNode<V>* node, int b) {
+        node->bucket = b;
+        node->prev = nullptr;
+        node->next = buckets_[b];
+        if (buckets_[b] != nullptr) buckets_[b]->prev = node;
+        buckets_[b] = node;
+    }
+
+    void unlink(RadixNode<V>* node) {
+        if (node->prev != nullptr) {
+            node->prev->next = node->next;
+        } else {
+            buckets_[node->bucket] = node->next;
+        }
+        if (node->next != nullptr) node->next->prev = node->prev;
+    }
+
+    void checkMonotone(long long key) const {
+        if (key < last_) {
+            throw logic_error("RadixHeap: key below last extracted key, queue must be monotone");
+        }
+    }
+
+    //move the smallest key into bucket 0 by redistributing the first
+    //non empty bucket around its minimum
+    void refill() {
+        if (buckets_[0] != nullptr) return;
+
+        int b = 1;
+        while (buckets_[b] == nullptr) b++;
+
+        long long minKey = buckets_[b]->key;
+        for (RadixNode<V>* cur = buckets_[b]; cur != nullptr; cur = cur->next) {
+            if (cur->key < minKey) minKey = cur->key;
+        }
+        last_ = minKey;
+
+        RadixNode<V>* cur = buckets_[b];
+        buckets_[b] = nullptr;
+        long long moved = 0;
+        while (cur != nullptr) {
+            RadixNode<V>* next = cur->next;
+            push(cur, bucketFor(cur->key));
+            cur = next;
+            moved++;
+        }
+        this->recordStructure(moved);
+    }
+
+    void releaseAll() {
+        if (pool_.skipRelease()) return;
+        for (int b = 0; b < BUCKETS; b++) {
+            RadixNode<V>* cur = buckets_[b];
+            while (cur != nullptr) {
+                RadixNode<V>* next = cur->next;
+                pool_.release(cur);
+                cur = next;
+            }
+        }
+    }
+
+public:
+    explicit RadixHeap(bool pooled = true) : last_(0), nodeCount_(0), pool_(pooled) {
+        for (int b = 0; b < BUCKETS; b++) buckets_[b] = nullptr;
+    }
+
+    ~RadixHeap() override {
+        releaseAll();
+    }
+
+    bool is_empty() override {
+        return nodeCount_ == 0;
+    }
+
+    void reset() override {
+        releaseAll();
+        pool_.reset();
+        for (int b = 0; b < BUCKETS; b++) buckets_[b] = nullptr;
+        last_ = 0;
+        nodeCount_ = 0;
+        this->resetCounters();
+    }
+
+    //times the system allocator was called for nodes
+    long long allocations() const { return pool_.allocations(); }
+
+    Node<long long, V>* insert(long long key, V value) override {
+        this->insertCount++;
+        OpTimer timer(this->insertHistogram());
+        checkMonotone(key);
+
+        RadixNode<V>* node = pool_.acquire(key, value);
+        push(node, bucketFor(key));
+        nodeCount_++;
+        return node;
+    }
+
+    pair<long long, V> find_min() override {
+        if (nodeCount_ == 0) {
+            throw runtime_error("Heap is empty");
+        }
+        if (buckets_[0] != nullptr) return {buckets_[0]->key, buckets_[0]->value};
+
+        int b = 1;
+        while (buckets_[b] == nullptr) b++;
+        RadixNode<V>* best = buckets_[b];
+        for (RadixNode<V>* cur = best->next; cur != nullptr; cur = cur->next) {
+            if (cur->key < best->key) best = cur;
+        }
+        return {best->key, best->value};
+    }
+
+    pair<long long, V> extract_min() override {
+        this->extractCount++;
+        OpTimer timer(this->extractHistogram());
+        if (nodeCount_ == 0) {
+            throw runtime_error("Heap is empty");
+        }
+
+        refill();
+        RadixNode<V>* node = buckets_[0];
+        unlink(node);
+
+        pair<long long, V> result = {node->key, node->value};
+        pool_.release(node);
+        nodeCount_--;
+        return result;
+    }
+
+    void decrease_key(Node<long long, V>* node, long long new_key) override {
+        this->decreaseKeyCount++;
+        OpTimer timer(this->decreaseKeyHistogram());
+        RadixNode<V>* x = static_cast<RadixNode<V>*>(node);
+
+        if (new_key > x->key) {
+            throw runtime_error("New key is greater than current key");
+        }
+        checkMonotone(new_key);
+
+        x->key = new_key;
+        int b = bucketFor(new_key);
+        if (b != x->bucket) {
+            unlink(x);
+            push(x, b);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,238 @@
+//interfaces to priorityQueue.h
+
+#ifndef RANK_PAIRING_HEAP_H
+#define RANK_PAIRING_HEAP_H
+
+#include "priorityQueue.h"
+#include "nodePool.h"
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//node of a half tree in binary form: left is the first child, right the next
+//sibling. a root has no right child, so right links the root list instead
+template<typename K, typename V>
+struct RankNode : public Node<K,V> {
+    RankNode* left;
+    RankNode* right;
+    RankNode* parent;  //binary tree parent, null for roots
+    int rank;
+
+    RankNode(K k, V v) : left(nullptr), right(nullptr), parent(nullptr), rank(0) {
+        this->key = k;
+        this->value = v;
+    }
+};
+
+//rank pairing heap, type 1 (haeupler, sen and tarjan)
+//a list of half ordered half trees with a pointer to the smallest root
+//insert and decrease_key only add a root, extract_min turns the old root's
+//left spine into roots and links roots of equal rank in a single pass, so
+//every operation is O(1) amortized except extract_min at O(log n)
+//decrease_key cuts the node with its left subtree and repairs ranks upward,
+//ranks of missing children count as -1
+//  root       rank = rank(left) + 1
+//  otherwise  rank = max of the children's ranks if they differ by more
+//             than one, else that max + 1
+//structure stat (PQ_INSTRUMENT builds): roots linked by each extract_min
+template<typename K, typename V>
+class RankPairingHeap final : public PriorityQueue<K,V> {
+private:
+    RankNode<K,V>* roots_;
+    RankNode<K,V>* min_;
+    int nodeCount_;
+    NodePool<RankNode<K,V>> pool_;
+
+    //one slot per rank for the linking pass, kept between calls
+    vector<RankNode<K,V>*> bucket_;
+
+    static int rankOf(const RankNode<K,V>* x) { return x ? x->rank : -1; }
+
+    void pushRoot(RankNode<K,V>* x) {
+        x->parent = nullptr;
+        x->right = roots_;
+        roots_ = x;
+        if (min_ == nullptr || x->key < min_->key) min_ = x;
+    }
+
+    //two roots of equal rank, the larger becomes the left child of the smaller
+    static RankNode<K,V>* link(RankNode<K,V>* x, RankNode<K,V>* y) {
+        if (y->key < x->key) {
+            RankNode<K,V>* t = x;
+            x = y;
+            y = t;
+        }
+        y->right = x->left;
+        if (y->right) y->right->parent = y;
+        y->parent = x;
+        x->left = y;
+        x->rank++;
+        return x;
+    }
+
+    //frees a binary tree (or the whole root list) without recursion by
+    //rotating left children up until the node on top has none
+    void deleteAll(RankNode<K,V>* n) {
+        while (n) {
+            if (n->left) {
+                RankNode<K,V>* l = n->left;
+                n->left = l->right;
+                l->right = n;
+                n = l;
+            } else {
+                RankNode<K,V>* next = n->right;
+                pool_.release(n);
+                n = next;
+            }
+        }
+    }
+
+public:
+    //pooled = false allocates every node with new
+    explicit RankPairingHeap(bool pooled = true)
+        : roots_(nullptr), min_(nullptr), nodeCount_(0), pool_(pooled) {}
+
+    ~RankPairingHeap() override {
+        if (!pool_.skipRelease()) deleteAll(roots_);
+    }
+
+    void reset() override {
+        if (!pool_.skipRelease()) deleteAll(roots_);
+        pool_.reset();
+        roots_ = nullptr;
+        min_ = nullptr;
+        nodeCount_ = 0;
+        this->resetCounters();
+    }
+
+    //times the system allocator was called for nodes
+    long long allocations() const { return pool_.allocations(); }
+
+    bool is_empty() override {
+        return min_ == nullptr;
+    }
+
+    Node<K,V>* insert(K key, V value) override {
+        this->insertCount++;
+        OpTimer timer(this->insertHistogram());
+        RankNode<K,V>* x = pool_.acquire(key, value);
+        pushRoot(x);
+        nodeCount_++;
+        return x;
+    }
+
+    pair<K,V> find_min() override {
+        if (min_ == nullptr) {
+            throw runtime_error("Heap is empty");
+        }
+        return {min_->key, min_->value};
+    }
+
+    pair<K,V> extract_min() override {
+        this->extractCount++;
+        OpTimer timer(this->extractHistogram());
+        if (min_ == nullptr) {
+            throw runtime_error("Heap is empty");
+        }
+
+        RankNode<K,V>* x = min_;
+        pair<K,V> result = {x->key, x->value};
+
+        //one pass: a root meeting another of its rank is linked with it and
+        //the result is set aside, not linked again this round
+        RankNode<K,V>* linked = nullptr;
+        long long count = 0;
+        auto place = [&](RankNode<K,V>* r) {
+            count++;
+            r->parent = nullptr;
+            size_t k = static_cast<size_t>(r->rank);
+            if (k >= bucket_.size()) bucket_.resize(k + 1, nullptr);
+            if (bucket_[k] == nullptr) {
+                bucket_[k] = r;
+                return;
+            }
+            RankNode<K,V>* w = link(r, bucket_[k]);
+            bucket_[k] = nullptr;
+            w->right = linked;
+            linked = w;
+        };
+
+        for (RankNode<K,V>* r = roots_; r != nullptr;) {
+            RankNode<K,V>* next = r->right;
+            if (r != x) place(r);
+            r = next;
+        }
+        for (RankNode<K,V>* c = x->left; c != nullptr;) {
+            RankNode<K,V>* next = c->right;
+            c->right = nullptr;
+            c->rank = rankOf(c->left) + 1;
+            place(c);
+            c = next;
+        }
+        this->recordStructure(count);
+
+        roots_ = nullptr;
+        min_ = nullptr;
+        for (RankNode<K,V>*& b : bucket_) {
+            if (b != nullptr) {
+                pushRoot(b);
+                b = nullptr;
+            }
+        }
+        while (linked != nullptr) {
+            RankNode<K,V>* next = linked->right;
+            pushRoot(linked);
+            linked = next;
+        }
+
+        nodeCount_--;
+        pool_.release(x);
+        return result;
+    }
+
+    void decrease_key(Node<K,V>* node, K new_key) override {
+        this->decreaseKeyCount++;
+        OpTimer timer(this->decreaseKeyHistogram());
+        RankNode<K,V>* x = static_cast<RankNode<K,V>*>(node);
+
+        if (new_key > x->key) {
+            throw runtime_error("New key is greater than current key");
+        }
+
+        x->key = new_key;
+        RankNode<K,V>* u = x->parent;
+        if (u == nullptr) {
+            if (x->key < min_->key) min_ = x;
+            return;
+        }
+
+        //x's right subtree takes its place, x leaves with its left subtree
+        RankNode<K,V>* y = x->right;
+        if (u->left == x) {
+            u->left = y;
+        } else {
+            u->right = y;
+        }
+        if (y) y->parent = u;
+        x->right = nullptr;
+        x->rank = rankOf(x->left) + 1;
+        pushRoot(x);
+
+        //ranks can only drop, stop at the first one that does not
+        while (u != nullptr) {
+            if (u->parent == nullptr) {
+                u->rank = rankOf(u->left) + 1;
+                break;
+            }
+            int r1 = rankOf(u->left);
+            int r2 = rankOf(u->right);
+            int hi = r1 > r2 ? r1 : r2;
+            int k = (r1 - r2 > 1 || r2 - r1 > 1) ? hi : hi + 1;
+            if (k >= u->rank) break;
+            u->rank = k;
+            u = u->parent;
+        }
+    }
+};
+
+#endif
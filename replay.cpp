@@ -0,0 +1,141 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include "graph.h"
+#include "graphGenerator.h"
+#include "dijkstra.h"
+#include "prim.h"
+#include "heapSelect.h"
+#include "heapTrace.h"
+#include "benchmark.h"
+
+using namespace std;
+
+//record a heap trace from one dijkstra or prim run, or replay a trace
+//through any heap with no graph work mixed in
+//  replay record <trace> [--algo dijkstra|prim] [--gen sparse|dense|grid] [--size n] [--seed s]
+//      first value of each list is used, seed picks the source vertex
+//  replay run <trace> [--heap a,b] [--reps n] [--warmup n] [--format csv|json]
+//      one row per heap, status is ok, unsupported (radix on a non monotone
+//      trace) or mismatch (the heap returned a key the trace did not)
+
+int recordTrace(const string& path, const BenchOptions& opts) {
+    string algo = opts.algorithms.empty() ? "dijkstra" : opts.algorithms[0];
+    string gen = opts.generators.empty() ? "sparse" : opts.generators[0];
+    int n = opts.sizes.empty() ? 100000 : opts.sizes[0];
+    bool directed = algo == "dijkstra";
+    if (algo != "dijkstra" && algo != "prim") {
+        cerr << "unknown algorithm: " << algo << endl;
+        return 1;
+    }
+
+    int gridSide = static_cast<int>(sqrt(n));
+    Graph g;
+    if (gen == "sparse") {
+        g = generateRandom(n, directed, 3 * n);
+    } else if (gen == "dense") {
+        g = generateRandom(n, directed, n * n / 4);
+    } else if (gen == "grid") {
+        g = generateGrid(gridSide, gridSide, directed);
+    } else {
+        cerr << "unknown generator: " << gen << endl;
+        return 1;
+    }
+
+    mt19937_64 rng(opts.seed);
+    int source = uniform_int_distribution<int>(0, g.num_vertices() - 1)(rng);
+
+    //the recording goes through a pairing heap, any correct heap gives a
+    //trace that replays the same on every other heap
+    PairingHeap<long long, int> inner;
+    TraceWriter out(path);
+    RecordingHeap<PairingHeap<long long, int>> pq(inner, out);
+    if (directed) {
+        dijkstra(g, source, pq);
+    } else {
+        prim_mst(g, source, pq);
+    }
+    out.close();
+
+    cerr << "recorded " << out.ops() << " ops (" << pq.insertCount << " inserts, " << pq.extractCount
+         << " extracts, " << pq.decreaseKeyCount << " decrease_keys) from " << algo << " on " << gen
+         << " n=" << g.num_vertices() << " source=" << source << endl;
+    return 0;
+}
+
+int runTrace(const string& path, const BenchOptions& opts) {
+    HeapTrace trace = readTrace(path);
+    const vector<string>& heaps = heapNames();
+    BenchWriter out(cout, opts.format);
+
+    for (const string& heap : heaps) {
+        if (!opts.wants(opts.heaps, heap)) continue;
+
+        withHeap(heap, [&](auto& pq) {
+            using PQ = typename std::decay<decltype(pq)>::type;
+            TraceReplayer<PQ> replayer;
+            vector<double> samples;
+            uint64_t checksum = 0;
+
+            //every heap gets a row. one that cannot replay the trace gets
+            //its status and no timings, and the other heaps still run
+            string status = "ok";
+            try {
+                for (int i = 0; i < opts.warmup + opts.reps; i++) {
+                    pq.reset();
+                    double ms = timeMs([&] { checksum = replayer.run(trace, pq); });
+                    if (i >= opts.warmup) samples.push_back(ms);
+                }
+            } catch (const logic_error& e) {
+                //radix on a non monotone (prim) trace
+                cerr << heap << ": " << e.what() << endl;
+                status = "unsupported";
+            } catch (const runtime_error& e) {
+                //the heap gave back a different key than the recorded one
+                cerr << heap << ": " << e.what() << endl;
+                status = "mismatch";
+            }
+
+            BenchRecord rec;
+            rec.add("heap", heap).add("status", status).add("ops", static_cast<long long>(trace.ops.size()))
+               .add("warmup", opts.warmup).add("reps", opts.reps);
+            if (status == "ok") {
+                SampleStats st = summarize(samples);
+                rec.add("median_ms", st.median).add("p95_ms", st.p95).add("mean_ms", st.mean)
+                   .add("stddev_ms", st.stddev).add("min_ms", st.min).add("max_ms", st.max)
+                   .add("ns_per_op", st.median * 1e6 / trace.ops.size())
+                   .add("checksum", to_string(checksum));
+            } else {
+                for (const char* key : {"median_ms", "p95_ms", "mean_ms", "stddev_ms", "min_ms", "max_ms",
+                                        "ns_per_op", "checksum"}) {
+                    rec.addMissing(key);
+                }
+            }
+            out.write(rec);
+        });
+    }
+
+    out.finish();
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "usage: replay record <trace> [options] | replay run <trace> [options]" << endl;
+        return 1;
+    }
+    string mode = argv[1];
+    string path = argv[2];
+
+    try {
+        BenchOptions opts = parseBenchOptions(argc, argv, 3);
+        if (mode == "record") return recordTrace(path, opts);
+        if (mode == "run") return runTrace(path, opts);
+        cerr << "unknown mode: " << mode << endl;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+    }
+    return 1;
+}
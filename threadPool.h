@@ -0,0 +1,164 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+//fixed set of worker threads for the parallel engines
+//the calling thread works too and is always tid 0, so a pool of size 1 runs
+//everything inline with no threads at all
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads)
+        : size_(threads), generation_(0), active_(0), stop_(false) {
+        if (threads < 1) throw std::invalid_argument("ThreadPool: need at least one thread");
+        for (int tid = 1; tid < threads; ++tid) {
+            workers_.emplace_back([this, tid] { workerLoop(tid); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    int size() const { return size_; }
+
+    //run fn(tid) once on every thread and wait for all of them
+    //the first exception thrown by any thread is rethrown here
+    void run_on_all(const std::function<void(int)>& fn) {
+        if (size_ == 1) {
+            fn(0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            job_ = &fn;
+            error_ = nullptr;
+            active_ = size_ - 1;
+            generation_++;
+        }
+        wake_.notify_all();
+
+        runJob(fn, 0);
+
+        std::unique_lock<std::mutex> lock(m_);
+        done_.wait(lock, [this] { return active_ == 0; });
+        job_ = nullptr;
+        if (error_) std::rethrow_exception(error_);
+    }
+
+    //split [0, count) into chunks of grain and hand them out on demand
+    //threads that finish early keep taking chunks, which balances uneven work
+    //fn(begin, end, tid)
+    template<typename F>
+    void parallel_for(size_t count, size_t grain, F fn) {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+
+        std::atomic<size_t> next(0);
+        run_on_all([&](int tid) {
+            while (true) {
+                size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+                if (begin >= count) break;
+                fn(begin, std::min(count, begin + grain), tid);
+            }
+        });
+    }
+
+private:
+    int size_;
+    std::vector<std::thread> workers_;
+    std::mutex m_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(int)>* job_ = nullptr;
+    std::exception_ptr error_;
+    long long generation_;
+    int active_;
+    bool stop_;
+
+    void runJob(const std::function<void(int)>& fn, int tid) {
+        try {
+            fn(tid);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_);
+            if (!error_) error_ = std::current_exception();
+        }
+    }
+
+    void workerLoop(int tid) {
+        long long seen = 0;
+        while (true) {
+            const std::function<void(int)>* job;
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+                job = job_;
+            }
+
+            runJob(*job, tid);
+
+            {
+                std::lock_guard<std::mutex> lock(m_);
+                active_--;
+            }
+            done_.notify_one();
+        }
+    }
+};
+
+//sort with one chunk per thread sorted in parallel, then pairwise merge
+//rounds. same result as std::sort for any pool size when cmp is a total order
+template<typename T, typename Cmp>
+inline void parallel_sort(std::vector<T>& data, ThreadPool& pool, Cmp cmp) {
+    const size_t count = data.size();
+    const size_t chunks = static_cast<size_t>(pool.size());
+    if (chunks == 1 || count < 4096) {
+        std::sort(data.begin(), data.end(), cmp);
+        return;
+    }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i) bounds[i] = count * i / chunks;
+
+    pool.parallel_for(chunks, 1, [&](size_t begin, size_t end, int) {
+        for (size_t c = begin; c < end; ++c) {
+            std::sort(data.begin() + bounds[c], data.begin() + bounds[c + 1], cmp);
+        }
+    });
+
+    for (size_t width = 1; width < chunks; width *= 2) {
+        const size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        pool.parallel_for(pairs, 1, [&](size_t begin, size_t end, int) {
+            for (size_t p = begin; p < end; ++p) {
+                size_t lo = p * 2 * width;
+                size_t mid = std::min(lo + width, chunks);
+                size_t hi = std::min(lo + 2 * width, chunks);
+                if (mid == hi) continue;
+                std::inplace_merge(data.begin() + bounds[lo], data.begin() + bounds[mid],
+                                   data.begin() + bounds[hi], cmp);
+            }
+        });
+    }
+}
+
+#endif
@@ -0,0 +1,230 @@
+#ifndef VERTEX_ORDER_H
+#define VERTEX_ORDER_H
+
+#include "graph.h"
+#include "csrGraph.h"
+#include "dijkstra.h"
+#include "prim.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+enum VertexOrder {
+    //breadth first from vertex 0, then from every vertex not reached yet
+    ORDER_BFS,
+    //reverse cuthill mckee: breadth first from a lowest degree vertex with
+    //each vertex's neighbors taken lowest degree first, then reversed. keeps
+    //every edge's endpoints close together in id, i.e. a small bandwidth
+    ORDER_RCM,
+    //highest degree first, so the vertices touched most share cache lines
+    ORDER_DEGREE,
+    //hilbert curve over a generateGrid layout, u = r * cols + c
+    ORDER_HILBERT
+};
+
+//out degree of every vertex
+template<typename GraphT>
+inline std::vector<int> vertexDegrees(const GraphT& g) {
+    std::vector<int> degree(g.num_vertices());
+    for (int u = 0; u < g.num_vertices(); ++u) degree[u] = static_cast<int>(g.neighbors(u).size());
+    return degree;
+}
+
+//vertices sorted by degree, ascending or descending, ties by id
+//a counting sort, degrees are small
+inline std::vector<int> byDegree(const std::vector<int>& degree, bool descending) {
+    const int n = static_cast<int>(degree.size());
+    int maxDegree = 0;
+    for (int d : degree) maxDegree = std::max(maxDegree, d);
+    std::vector<int> offsets(maxDegree + 2, 0);
+    for (int d : degree) offsets[(descending ? maxDegree - d : d) + 1]++;
+    for (int d = 0; d <= maxDegree; ++d) offsets[d + 1] += offsets[d];
+    std::vector<int> sorted(n);
+    for (int v = 0; v < n; ++v) sorted[offsets[descending ? maxDegree - degree[v] : degree[v]]++] = v;
+    return sorted;
+}
+
+//position of (x, y) along the hilbert curve filling a side x side square,
+//side a power of two
+inline uint64_t hilbertIndex(uint64_t side, uint64_t x, uint64_t y) {
+    uint64_t d = 0;
+    for (uint64_t s = side / 2; s > 0; s /= 2) {
+        const uint64_t rx = (x & s) ? 1 : 0;
+        const uint64_t ry = (y & s) ? 1 : 0;
+        d += s * s * ((3 * rx) ^ ry);
+        //rotate the quadrant so the curve inside it starts where it enters
+        if (ry == 0) {
+            if (rx == 1) {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+//new order of g's vertices, order[i] is the old id that becomes i
+//gridCols is the grid width and only used (and required) for ORDER_HILBERT
+//directed graphs are walked along out edges
+template<typename GraphT>
+inline std::vector<int> vertexOrder(const GraphT& g, VertexOrder order, int gridCols = 0) {
+    const int n = g.num_vertices();
+    std::vector<int> result;
+    result.reserve(n);
+
+    if (order == ORDER_DEGREE) return byDegree(vertexDegrees(g), true);
+
+    if (order == ORDER_HILBERT) {
+        if (gridCols <= 0 || n % gridCols != 0) {
+            throw std::invalid_argument("vertexOrder: hilbert order needs the grid width");
+        }
+        const int rows = n / gridCols;
+        uint64_t side = 1;
+        while (side < static_cast<uint64_t>(std::max(rows, gridCols))) side *= 2;
+        std::vector<std::pair<uint64_t, int>> keyed(n);
+        for (int u = 0; u < n; ++u) keyed[u] = {hilbertIndex(side, u % gridCols, u / gridCols), u};
+        std::sort(keyed.begin(), keyed.end());
+        for (const auto& k : keyed) result.push_back(k.second);
+        return result;
+    }
+
+    //bfs and rcm, one breadth first pass per component
+    const bool rcm = order == ORDER_RCM;
+    std::vector<int> degree;
+    std::vector<int> starts;
+    if (rcm) {
+        degree = vertexDegrees(g);
+        starts = byDegree(degree, false);
+    } else {
+        starts.resize(n);
+        for (int v = 0; v < n; ++v) starts[v] = v;
+    }
+
+    std::vector<char> seen(n, 0);
+    std::vector<int> next;
+    for (int s : starts) {
+        if (seen[s]) continue;
+        seen[s] = 1;
+        result.push_back(s);
+        for (size_t i = result.size() - 1; i < result.size(); ++i) {
+            const int u = result[i];
+            next.clear();
+            for (const auto& e : g.neighbors(u)) {
+                if (seen[e.to]) continue;
+                seen[e.to] = 1;
+                next.push_back(e.to);
+            }
+            if (rcm) {
+                std::sort(next.begin(), next.end(), [&](int a, int b) {
+                    return degree[a] != degree[b] ? degree[a] < degree[b] : a < b;
+                });
+            }
+            result.insert(result.end(), next.begin(), next.end());
+        }
+    }
+    if (rcm) std::reverse(result.begin(), result.end());
+    return result;
+}
+
+//g relabeled into a csr graph so that neighbors in the order sit next to
+//each other in dist, handle and the edge array, plus the permutation to get
+//back. dijkstra and prim_mst take a ReorderedGraph directly: ids go in and
+//results come out in the original numbering, the relabeled graph is only
+//seen inside. anything else runs on graph() with to_new / restore by hand
+class ReorderedGraph {
+public:
+    template<typename GraphT>
+    ReorderedGraph(const GraphT& g, VertexOrder order, int gridCols = 0)
+        : ReorderedGraph(g, vertexOrder(g, order, gridCols)) {}
+
+    //order[i] is the old id that becomes i, it must be a permutation
+    template<typename GraphT>
+    ReorderedGraph(const GraphT& g, std::vector<int> order) : toOld_(std::move(order)) {
+        const int n = g.num_vertices();
+        if (static_cast<int>(toOld_.size()) != n) throw std::invalid_argument("ReorderedGraph: order has the wrong size");
+        toNew_.assign(n, -1);
+        for (int i = 0; i < n; ++i) {
+            const int v = toOld_[i];
+            if (v < 0 || v >= n || toNew_[v] >= 0) throw std::invalid_argument("ReorderedGraph: order is not a permutation");
+            toNew_[v] = i;
+        }
+
+        //per vertex edge order is kept, only the ids change
+        std::vector<long long> offsets(n + 1, 0);
+        for (int i = 0; i < n; ++i) offsets[i + 1] = offsets[i] + static_cast<long long>(g.neighbors(toOld_[i]).size());
+        std::vector<Graph::Edge> edges;
+        edges.reserve(static_cast<size_t>(offsets[n]));
+        for (int i = 0; i < n; ++i) {
+            for (const auto& e : g.neighbors(toOld_[i])) edges.push_back({toNew_[e.to], e.weight});
+        }
+        graph_ = CSRGraph(n, g.directed(), std::move(offsets), std::move(edges));
+    }
+
+    int num_vertices() const { return graph_.num_vertices(); }
+    bool directed() const { return graph_.directed(); }
+
+    //the relabeled graph, in new ids
+    const CSRGraph& graph() const { return graph_; }
+
+    int to_new(int v) const { return toNew_[v]; }
+    int to_old(int v) const { return toOld_[v]; }
+
+    //per vertex values indexed by new id, reindexed by old id
+    template<typename T>
+    std::vector<T> restore(const std::vector<T>& byNew) const {
+        std::vector<T> byOld(byNew.size());
+        for (size_t v = 0; v < byNew.size(); ++v) byOld[v] = byNew[toNew_[v]];
+        return byOld;
+    }
+
+    DijkstraResult restore(const DijkstraResult& res) const {
+        DijkstraResult out;
+        out.dist = restore(res.dist);
+        out.parent = restoreParents(res.parent);
+        return out;
+    }
+
+    PrimResult restore(const PrimResult& res) const {
+        PrimResult out;
+        out.total_weight = res.total_weight;
+        out.parent = restoreParents(res.parent);
+        out.key = restore(res.key);
+        out.connected = res.connected;
+        return out;
+    }
+
+private:
+    CSRGraph graph_;
+    std::vector<int> toNew_;
+    std::vector<int> toOld_;
+
+    //parents are ids themselves, so they are translated as well as moved
+    std::vector<int> restoreParents(const std::vector<int>& byNew) const {
+        std::vector<int> byOld(byNew.size());
+        for (size_t v = 0; v < byNew.size(); ++v) {
+            const int p = byNew[toNew_[v]];
+            byOld[v] = p < 0 ? -1 : toOld_[p];
+        }
+        return byOld;
+    }
+};
+
+//dijkstra on the relabeled graph, source and result in original ids
+template<typename PQ>
+inline DijkstraResult dijkstra(const ReorderedGraph& g, int source, PQ& pq, bool lazyInsert = false) {
+    if (source < 0 || source >= g.num_vertices()) throw std::out_of_range("dijkstra: source out of range");
+    return g.restore(dijkstra(g.graph(), g.to_new(source), pq, lazyInsert));
+}
+
+//prim on the relabeled graph, start and result in original ids
+template<typename PQ>
+inline PrimResult prim_mst(const ReorderedGraph& g, int start, PQ& pq, bool lazyInsert = false) {
+    if (start < 0 || start >= g.num_vertices()) throw std::out_of_range("prim_mst: start out of range");
+    return g.restore(prim_mst(g.graph(), g.to_new(start), pq, lazyInsert));
+}
+
+#endif